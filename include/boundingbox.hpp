@@ -0,0 +1,130 @@
+#ifndef ND_MATH_BOUNDING_BOX_HPP
+#define ND_MATH_BOUNDING_BOX_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+#include "matrix.hpp"
+
+namespace nd::math
+{
+
+///
+/// Axis-aligned bounding box of \a Order dimensional points, given by the per-component minimum and maximum of all enclosed points.
+///
+/// \ref empty returns the identity of \ref merge, an inverted box whose minimum is larger than its maximum, so boxes are built by merging
+/// points or boxes into it.
+///
+template <typename ValueType, std::size_t Order>
+struct BoundingBox
+{
+	using VectorType = ColumnVector<ValueType, Order>;
+
+	VectorType minimum;
+	VectorType maximum;
+
+	///
+	/// Returns the box enclosing nothing: minimum at infinity or the largest finite value, maximum at their negation.
+	///
+	static constexpr BoundingBox empty()
+	{
+		constexpr ValueType largest = std::numeric_limits<ValueType>::has_infinity ? std::numeric_limits<ValueType>::infinity()
+																					: std::numeric_limits<ValueType>::max();
+		constexpr ValueType lowest	= std::numeric_limits<ValueType>::has_infinity ? -std::numeric_limits<ValueType>::infinity()
+																					: std::numeric_limits<ValueType>::lowest();
+
+		BoundingBox returnValue;
+
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			returnValue.minimum[order] = largest;
+			returnValue.maximum[order] = lowest;
+		}
+
+		return returnValue;
+	}
+
+	///
+	/// Returns whether the box encloses no point, i.e. its minimum exceeds its maximum in any component.
+	///
+	constexpr bool isEmpty() const
+	{
+		bool returnValue = false;
+
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			returnValue |= (this->minimum[order] > this->maximum[order]);
+		}
+
+		return returnValue;
+	}
+
+	constexpr bool contains(const VectorType &point) const
+	{
+		bool returnValue = true;
+
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			returnValue &= (point[order] >= this->minimum[order]) & (point[order] <= this->maximum[order]);
+		}
+
+		return returnValue;
+	}
+
+	constexpr VectorType center() const
+	{
+		return (this->minimum + this->maximum) / static_cast<ValueType>(2);
+	}
+
+	constexpr VectorType extent() const
+	{
+		return this->maximum - this->minimum;
+	}
+
+	///
+	/// Grows the box to enclose \a point.
+	///
+	constexpr BoundingBox &merge(const VectorType &point)
+	{
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			this->minimum[order] = std::min(this->minimum[order], point[order]);
+			this->maximum[order] = std::max(this->maximum[order], point[order]);
+		}
+
+		return *this;
+	}
+
+	///
+	/// Grows the box to enclose \a other.
+	///
+	constexpr BoundingBox &merge(const BoundingBox &other)
+	{
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			this->minimum[order] = std::min(this->minimum[order], other.minimum[order]);
+			this->maximum[order] = std::max(this->maximum[order], other.maximum[order]);
+		}
+
+		return *this;
+	}
+
+	constexpr bool operator==(const BoundingBox &other) const = default;
+};
+
+template <typename T>
+using BoundingBox2 = BoundingBox<T, 2u>;
+
+template <typename T>
+using BoundingBox3 = BoundingBox<T, 3u>;
+
+using BoundingBox2_f = BoundingBox2<float>;
+using BoundingBox3_f = BoundingBox3<float>;
+
+using BoundingBox2_d = BoundingBox2<double>;
+using BoundingBox3_d = BoundingBox3<double>;
+
+} // namespace nd::math
+
+#endif // ND_MATH_BOUNDING_BOX_HPP
@@ -1,7 +1,15 @@
 #ifndef ND_MATH_DETAIL_HPP
 #define ND_MATH_DETAIL_HPP
 
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
 #include "common.hpp"
+#include "simd.hpp"
 #include "traits.hpp"
 
 namespace nd::math
@@ -21,26 +29,344 @@ class Matrix;
 namespace detail
 {
 
+///
+/// Alignment of the storage of \a Count elements: the largest power of two dividing its size, so alignment never adds padding, capped at the
+/// vector register size.
+///
+template <
+	typename ValueType,
+	std::size_t			Count>
+inline constexpr std::size_t storageAlignment = std::clamp<std::size_t>((Count * sizeof (ValueType)) & (~(Count * sizeof (ValueType)) + 1u),
+																		 alignof (ValueType), std::max(simd::registerSize, alignof (ValueType)));
+
 template <
 	std::size_t			Columns,
 	typename ValueType>
-inline ValueType *rowPointer(ValueType *data, const std::size_t index)
+inline constexpr ValueType *rowPointer(ValueType *data, const std::size_t index)
 {
 	return (data + index * Columns);
 }
 
-//template <
-//	typename ValueType,
-//	std::size_t			Rows,
-//	std::size_t			Columns>
-//Matrix<ValueType, Rows, Columns> gaussJordan(const Matrix<ValueType, Rows, Columns> &matrix)
-//{
-//	Matrix<ValueType, Rows, Columns> returnValue;
+template <typename ValueType>
+inline constexpr ValueType absolute(const ValueType value)
+{
+	return (value < ValueType{}) ? -value : value;
+}
+
+///
+/// Factorizes the row-major $N \times N$ matrix at \a data in place into $P A = L U$ using partial pivoting. The strictly lower triangle
+/// receives the unit lower triangular factor $L$, the upper triangle $U$, and \a permutation the source row of every row of $P A$.
+///
+/// Returns the sign of the permutation, or zero if a pivot vanished, in which case the factorization is incomplete.
+///
+template <std::size_t N, typename ValueType>
+inline constexpr ValueType luDecompose(ValueType *data, std::size_t *permutation)
+{
+	static_assert(std::is_floating_point_v<ValueType>, "LU factorization requires floating point elements");
+
+	ValueType sign = static_cast<ValueType>(1);
+
+	for (std::size_t i = 0u; i < N; ++i)
+	{
+		permutation[i] = i;
+	}
+
+	for (std::size_t k = 0u; k < N; ++k)
+	{
+		std::size_t pivot = k;
+
+		for (std::size_t i = k + 1u; i < N; ++i)
+		{
+			if (absolute(data[i * N + k]) > absolute(data[pivot * N + k]))
+			{
+				pivot = i;
+			}
+		}
+
+		if (data[pivot * N + k] == ValueType{})
+		{
+			return ValueType{};
+		}
+
+		if (pivot != k)
+		{
+			for (std::size_t j = 0u; j < N; ++j)
+			{
+				std::swap(data[pivot * N + j], data[k * N + j]);
+			}
+
+			std::swap(permutation[pivot], permutation[k]);
+			sign = -sign;
+		}
+
+		const ValueType inversePivot = static_cast<ValueType>(1) / data[k * N + k];
+
+		for (std::size_t i = k + 1u; i < N; ++i)
+		{
+			const ValueType factor = (data[i * N + k] *= inversePivot);
+
+			for (std::size_t j = k + 1u; j < N; ++j)
+			{
+				data[i * N + j] -= factor * data[k * N + j];
+			}
+		}
+	}
+
+	return sign;
+}
+
+///
+/// Solves $A X = B$ for the $N \times K$ matrix \a result given the factorization \a lu, \a permutation of $A$ computed by \ref luDecompose
+/// and the $N \times K$ right-hand side \a rhs.
+///
+template <std::size_t N, std::size_t K, typename ValueType>
+inline constexpr void luSolve(const ValueType *lu, const std::size_t *permutation, const ValueType *rhs, ValueType *result)
+{
+	for (std::size_t i = 0u; i < N; ++i)
+	{
+		common::copy(result + i * K, rhs + permutation[i] * K, K);
+	}
+
+	// Forward substitution with the unit lower triangle
+	for (std::size_t i = 1u; i < N; ++i)
+	{
+		for (std::size_t p = 0u; p < i; ++p)
+		{
+			const ValueType factor = lu[i * N + p];
+
+			for (std::size_t j = 0u; j < K; ++j)
+			{
+				result[i * K + j] -= factor * result[p * K + j];
+			}
+		}
+	}
+
+	// Back substitution with the upper triangle
+	for (std::size_t i = N; i-- > 0u;)
+	{
+		for (std::size_t p = i + 1u; p < N; ++p)
+		{
+			const ValueType factor = lu[i * N + p];
+
+			for (std::size_t j = 0u; j < K; ++j)
+			{
+				result[i * K + j] -= factor * result[p * K + j];
+			}
+		}
+
+		const ValueType inversePivot = static_cast<ValueType>(1) / lu[i * N + i];
+
+		for (std::size_t j = 0u; j < K; ++j)
+		{
+			result[i * K + j] *= inversePivot;
+		}
+	}
+}
+
+///
+/// Returns the determinant of the row-major $N \times N$ matrix at \a data. Orders up to four are expanded into cofactors without branches,
+/// larger ones are factorized: integer ones by fraction-free elimination, which stays exact, floating point ones by LU decomposition.
+///
+template <std::size_t N, typename ValueType>
+inline constexpr ValueType determinant(const ValueType *a)
+{
+	if constexpr (N == 1u)
+	{
+		return a[0u];
+	}
+	else if constexpr (N == 2u)
+	{
+		return a[0u] * a[3u] - a[1u] * a[2u];
+	}
+	else if constexpr (N == 3u)
+	{
+		return a[0u] * (a[4u] * a[8u] - a[5u] * a[7u]) -
+			   a[1u] * (a[3u] * a[8u] - a[5u] * a[6u]) +
+			   a[2u] * (a[3u] * a[7u] - a[4u] * a[6u]);
+	}
+	else if constexpr (N == 4u)
+	{
+		// 2x2 minors of the upper and the lower two rows
+		const ValueType s0 = a[0u] * a[5u] - a[4u] * a[1u];
+		const ValueType s1 = a[0u] * a[6u] - a[4u] * a[2u];
+		const ValueType s2 = a[0u] * a[7u] - a[4u] * a[3u];
+		const ValueType s3 = a[1u] * a[6u] - a[5u] * a[2u];
+		const ValueType s4 = a[1u] * a[7u] - a[5u] * a[3u];
+		const ValueType s5 = a[2u] * a[7u] - a[6u] * a[3u];
+
+		const ValueType c0 = a[8u] * a[13u] - a[12u] * a[9u];
+		const ValueType c1 = a[8u] * a[14u] - a[12u] * a[10u];
+		const ValueType c2 = a[8u] * a[15u] - a[12u] * a[11u];
+		const ValueType c3 = a[9u] * a[14u] - a[13u] * a[10u];
+		const ValueType c4 = a[9u] * a[15u] - a[13u] * a[11u];
+		const ValueType c5 = a[10u] * a[15u] - a[14u] * a[11u];
+
+		return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+	}
+	else if constexpr (std::is_integral_v<ValueType>)
+	{
+		// Fraction-free Bareiss elimination, every division is exact so integer determinants stay exact
+		ValueType m[N * N];
+		common::copy(m, a, N * N);
+
+		ValueType sign		= static_cast<ValueType>(1);
+		ValueType previous	= static_cast<ValueType>(1);
+
+		for (std::size_t k = 0u; k < (N - 1u); ++k)
+		{
+			if (m[k * N + k] == ValueType{})
+			{
+				std::size_t pivot = k + 1u;
+
+				while ((pivot < N) && (m[pivot * N + k] == ValueType{}))
+				{
+					++pivot;
+				}
+
+				if (pivot == N)
+				{
+					return ValueType{};
+				}
+
+				for (std::size_t j = k; j < N; ++j)
+				{
+					std::swap(m[pivot * N + j], m[k * N + j]);
+				}
+
+				sign = -sign;
+			}
+
+			for (std::size_t i = k + 1u; i < N; ++i)
+			{
+				for (std::size_t j = k + 1u; j < N; ++j)
+				{
+					m[i * N + j] = (m[i * N + j] * m[k * N + k] - m[i * N + k] * m[k * N + j]) / previous;
+				}
+			}
+
+			previous = m[k * N + k];
+		}
+
+		return sign * m[N * N - 1u];
+	}
+	else
+	{
+		ValueType	lu[N * N];
+		std::size_t	permutation[N];
+
+		common::copy(lu, a, N * N);
+
+		ValueType returnValue = luDecompose<N>(lu, permutation);
+
+		for (std::size_t i = 0u; (i < N) & (returnValue != ValueType{}); ++i)
+		{
+			returnValue *= lu[i * N + i];
+		}
+
+		return returnValue;
+	}
+}
+
+///
+/// Writes the inverse of the row-major $N \times N$ matrix at \a a to \a b. Orders up to four use the adjugate divided by the determinant,
+/// computed from shared 2x2 minors, larger ones an LU factorization. The result is not finite if the matrix is singular.
+///
+template <std::size_t N, typename ValueType>
+inline constexpr void inverse(const ValueType *a, ValueType *b)
+{
+	static_assert(std::is_floating_point_v<ValueType>, "Inversion requires floating point elements");
+
+	if constexpr (N == 1u)
+	{
+		b[0u] = static_cast<ValueType>(1) / a[0u];
+	}
+	else if constexpr (N == 2u)
+	{
+		const ValueType inverseDeterminant = static_cast<ValueType>(1) / determinant<2u>(a);
+
+		b[0u] =  a[3u] * inverseDeterminant;
+		b[1u] = -a[1u] * inverseDeterminant;
+		b[2u] = -a[2u] * inverseDeterminant;
+		b[3u] =  a[0u] * inverseDeterminant;
+	}
+	else if constexpr (N == 3u)
+	{
+		const ValueType c00 = a[4u] * a[8u] - a[5u] * a[7u];
+		const ValueType c01 = a[5u] * a[6u] - a[3u] * a[8u];
+		const ValueType c02 = a[3u] * a[7u] - a[4u] * a[6u];
+
+		const ValueType inverseDeterminant = static_cast<ValueType>(1) / (a[0u] * c00 + a[1u] * c01 + a[2u] * c02);
+
+		b[0u] = c00 * inverseDeterminant;
+		b[1u] = (a[2u] * a[7u] - a[1u] * a[8u]) * inverseDeterminant;
+		b[2u] = (a[1u] * a[5u] - a[2u] * a[4u]) * inverseDeterminant;
+		b[3u] = c01 * inverseDeterminant;
+		b[4u] = (a[0u] * a[8u] - a[2u] * a[6u]) * inverseDeterminant;
+		b[5u] = (a[2u] * a[3u] - a[0u] * a[5u]) * inverseDeterminant;
+		b[6u] = c02 * inverseDeterminant;
+		b[7u] = (a[1u] * a[6u] - a[0u] * a[7u]) * inverseDeterminant;
+		b[8u] = (a[0u] * a[4u] - a[1u] * a[3u]) * inverseDeterminant;
+	}
+	else if constexpr (N == 4u)
+	{
+		const ValueType s0 = a[0u] * a[5u] - a[4u] * a[1u];
+		const ValueType s1 = a[0u] * a[6u] - a[4u] * a[2u];
+		const ValueType s2 = a[0u] * a[7u] - a[4u] * a[3u];
+		const ValueType s3 = a[1u] * a[6u] - a[5u] * a[2u];
+		const ValueType s4 = a[1u] * a[7u] - a[5u] * a[3u];
+		const ValueType s5 = a[2u] * a[7u] - a[6u] * a[3u];
 
-//	// TODO
+		const ValueType c0 = a[8u] * a[13u] - a[12u] * a[9u];
+		const ValueType c1 = a[8u] * a[14u] - a[12u] * a[10u];
+		const ValueType c2 = a[8u] * a[15u] - a[12u] * a[11u];
+		const ValueType c3 = a[9u] * a[14u] - a[13u] * a[10u];
+		const ValueType c4 = a[9u] * a[15u] - a[13u] * a[11u];
+		const ValueType c5 = a[10u] * a[15u] - a[14u] * a[11u];
 
-//	return returnValue;
-//}
+		const ValueType inverseDeterminant = static_cast<ValueType>(1) / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+
+		b[0u]	= ( a[5u] * c5 - a[6u] * c4 + a[7u] * c3) * inverseDeterminant;
+		b[1u]	= (-a[1u] * c5 + a[2u] * c4 - a[3u] * c3) * inverseDeterminant;
+		b[2u]	= ( a[13u] * s5 - a[14u] * s4 + a[15u] * s3) * inverseDeterminant;
+		b[3u]	= (-a[9u] * s5 + a[10u] * s4 - a[11u] * s3) * inverseDeterminant;
+
+		b[4u]	= (-a[4u] * c5 + a[6u] * c2 - a[7u] * c1) * inverseDeterminant;
+		b[5u]	= ( a[0u] * c5 - a[2u] * c2 + a[3u] * c1) * inverseDeterminant;
+		b[6u]	= (-a[12u] * s5 + a[14u] * s2 - a[15u] * s1) * inverseDeterminant;
+		b[7u]	= ( a[8u] * s5 - a[10u] * s2 + a[11u] * s1) * inverseDeterminant;
+
+		b[8u]	= ( a[4u] * c4 - a[5u] * c2 + a[7u] * c0) * inverseDeterminant;
+		b[9u]	= (-a[0u] * c4 + a[1u] * c2 - a[3u] * c0) * inverseDeterminant;
+		b[10u]	= ( a[12u] * s4 - a[13u] * s2 + a[15u] * s0) * inverseDeterminant;
+		b[11u]	= (-a[8u] * s4 + a[9u] * s2 - a[11u] * s0) * inverseDeterminant;
+
+		b[12u]	= (-a[4u] * c3 + a[5u] * c1 - a[6u] * c0) * inverseDeterminant;
+		b[13u]	= ( a[0u] * c3 - a[1u] * c1 + a[2u] * c0) * inverseDeterminant;
+		b[14u]	= (-a[12u] * s3 + a[13u] * s1 - a[14u] * s0) * inverseDeterminant;
+		b[15u]	= ( a[8u] * s3 - a[9u] * s1 + a[10u] * s0) * inverseDeterminant;
+	}
+	else
+	{
+		ValueType	lu[N * N];
+		ValueType	identity[N * N] = {};
+		std::size_t	permutation[N];
+
+		common::copy(lu, a, N * N);
+
+		if (luDecompose<N>(lu, permutation) == ValueType{})
+		{
+			std::fill_n(b, N * N, std::numeric_limits<ValueType>::quiet_NaN());
+			return;
+		}
+
+		for (std::size_t i = 0u; i < N; ++i)
+		{
+			identity[i * N + i] = static_cast<ValueType>(1);
+		}
+
+		luSolve<N, N>(lu, permutation, identity, b);
+	}
+}
 
 template <
 	typename ValueType,
@@ -96,6 +422,25 @@ inline constexpr SubscriptType_v<ValueType, Rows, Columns> subscript(ValueType *
 	}
 }
 
+///
+/// Subscript of a constant matrix, which refers to constant elements.
+///
+template <
+	typename ValueType,
+	std::size_t			Rows,
+	std::size_t			Columns>
+inline constexpr SubscriptType_v<const ValueType, Rows, Columns> subscript(const ValueType *data, const std::size_t index)
+{
+	if constexpr ((Rows == 1u) | (Columns == 1u))
+	{
+		return data[index];
+	}
+	else
+	{
+		return MatrixRowView<const ValueType, Columns>{detail::rowPointer<Columns>(data, index)};
+	}
+}
+
 template <
 	typename ValueType,
 	std::size_t			Rows,
@@ -0,0 +1,417 @@
+#ifndef ND_MATH_DUAL_QUATERNION_HPP
+#define ND_MATH_DUAL_QUATERNION_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#include "matrix.hpp"
+#include "quaternion.hpp"
+#include "traits.hpp"
+#include "vectorsoa.hpp"
+
+namespace nd::math
+{
+
+namespace detail
+{
+
+///
+/// Computes the translation $2 (w d - d_w v + v \times d)$ of the unit dual quaternion with real part $w + v$ and dual part $d_w + d$, the
+/// vector part of $2 q_\epsilon q^*$. Components may be scalars or vector registers like for \ref rotate.
+///
+template <typename Lane>
+inline constexpr void dualQuaternionTranslation(const Lane (&real)[4u], const Lane (&dual)[4u], Lane &x, Lane &y, Lane &z)
+{
+	x = real[0u] * dual[1u] - dual[0u] * real[1u] + (real[2u] * dual[3u] - real[3u] * dual[2u]);
+	y = real[0u] * dual[2u] - dual[0u] * real[2u] + (real[3u] * dual[1u] - real[1u] * dual[3u]);
+	z = real[0u] * dual[3u] - dual[0u] * real[3u] + (real[1u] * dual[2u] - real[2u] * dual[1u]);
+
+	x += x;
+	y += y;
+	z += z;
+}
+
+} // namespace detail
+
+///
+/// Unit dual quaternions $q + \epsilon q_\epsilon$ represent rigid transformations: the real part \ref real is the rotation and the dual
+/// part \ref dual encodes the translation $t$ applied after it as $q_\epsilon = \frac{1}{2} t q$.
+///
+/// Eight numbers instead of the twelve of an affine matrix, and blending them linearly and normalizing yields a rigid transformation
+/// again, which is what \ref skinPoints relies on.
+///
+template <typename ValueType>
+class DualQuaternion
+{
+public:
+	using QuaternionType = Quaternion<ValueType>;
+
+	constexpr DualQuaternion() = default;
+
+	constexpr DualQuaternion(const QuaternionType &real, const QuaternionType &dual) :
+		_real(real),
+		_dual(dual)
+	{
+	}
+
+	///
+	/// Creates the rigid transformation rotating by the unit quaternion \a rotation, then translating by \a translation.
+	///
+	template <std::size_t Rows, std::size_t Columns, typename Unused_ = void, typename = traits::Enable3DVector<Rows, Columns, Unused_>>
+	constexpr DualQuaternion(const QuaternionType &rotation, const Matrix<ValueType, Rows, Columns> &translation) :
+		_real(rotation),
+		_dual(QuaternionType{0, translation[0u], translation[1u], translation[2u]} * rotation * static_cast<ValueType>(0.5))
+	{
+	}
+
+	constexpr DualQuaternion(const traits::initialization::Identity) :
+		_real(1, 0, 0, 0),
+		_dual(traits::initialization::zero)
+	{
+	}
+
+	constexpr const QuaternionType &real() const
+	{
+		return this->_real;
+	}
+
+	constexpr QuaternionType &real()
+	{
+		return this->_real;
+	}
+
+	constexpr const QuaternionType &dual() const
+	{
+		return this->_dual;
+	}
+
+	constexpr QuaternionType &dual()
+	{
+		return this->_dual;
+	}
+
+	constexpr const QuaternionType &rotation() const
+	{
+		return this->_real;
+	}
+
+	constexpr Vector3<ValueType> translation() const
+	{
+		const ValueType real[4u] = {this->_real[0u], this->_real[1u], this->_real[2u], this->_real[3u]};
+		const ValueType dual[4u] = {this->_dual[0u], this->_dual[1u], this->_dual[2u], this->_dual[3u]};
+
+		Vector3<ValueType> returnValue;
+		detail::dualQuaternionTranslation(real, dual, returnValue[0u], returnValue[1u], returnValue[2u]);
+		return returnValue;
+	}
+
+	///
+	/// Scales both parts so the real part has unit length and removes the component of the dual part along the real part, which blending
+	/// introduces, so the result is a rigid transformation again.
+	///
+	constexpr DualQuaternion &normalize()
+	{
+		const ValueType norm = this->_real.norm();
+
+		this->_real /= norm;
+		this->_dual /= norm;
+		this->_dual -= this->_real * this->_real.dot(this->_dual);
+
+		return *this;
+	}
+
+	constexpr DualQuaternion normalized() const
+	{
+		DualQuaternion returnValue = *this;
+		returnValue.normalize();
+		return returnValue;
+	}
+
+	///
+	/// Conjugates both parts, which inverts a unit dual quaternion.
+	///
+	constexpr DualQuaternion &conjugate()
+	{
+		this->_real.conjugate();
+		this->_dual.conjugate();
+		return *this;
+	}
+
+	constexpr DualQuaternion conjugated() const
+	{
+		DualQuaternion returnValue = *this;
+		returnValue.conjugate();
+		return returnValue;
+	}
+
+	///
+	/// Inverts this unit dual quaternion, which is its conjugate.
+	///
+	constexpr DualQuaternion &invert()
+	{
+		return this->conjugate();
+	}
+
+	constexpr DualQuaternion inverted() const
+	{
+		return this->conjugated();
+	}
+
+	///
+	/// Returns \a point rotated and translated by this unit dual quaternion, without expanding it into a matrix first.
+	///
+	template <std::size_t Rows, std::size_t Columns, typename Unused_ = void, typename = traits::Enable3DVector<Rows, Columns, Unused_>>
+	constexpr Matrix<ValueType, Rows, Columns> transformPoint(const Matrix<ValueType, Rows, Columns> &point) const
+	{
+		Matrix<ValueType, Rows, Columns>	returnValue	= this->_real.rotate(point);
+		const Vector3<ValueType>			translation	= this->translation();
+
+		for (std::size_t index = 0u; index < 3u; ++index)
+		{
+			returnValue[index] += translation[index];
+		}
+
+		return returnValue;
+	}
+
+	///
+	/// Returns \a direction rotated by this unit dual quaternion, directions are not translated.
+	///
+	template <std::size_t Rows, std::size_t Columns, typename Unused_ = void, typename = traits::Enable3DVector<Rows, Columns, Unused_>>
+	constexpr Matrix<ValueType, Rows, Columns> transformDirection(const Matrix<ValueType, Rows, Columns> &direction) const
+	{
+		return this->_real.rotate(direction);
+	}
+
+	///
+	/// Returns the homogeneous transformation matrix of this unit dual quaternion for column vectors.
+	///
+	constexpr Matrix4x4<ValueType> toTransformationMatrix() const
+	{
+		Matrix4x4<ValueType>		returnValue	= this->_real.toRotationMatrix();
+		const Vector3<ValueType>	translation	= this->translation();
+
+		for (std::size_t row = 0u; row < 3u; ++row)
+		{
+			returnValue[row][3u] = translation[row];
+		}
+
+		return returnValue;
+	}
+
+	constexpr DualQuaternion &operator+=(const DualQuaternion &other)
+	{
+		this->_real += other._real;
+		this->_dual += other._dual;
+		return *this;
+	}
+
+	constexpr DualQuaternion &operator*=(const ValueType scalar)
+	{
+		this->_real *= scalar;
+		this->_dual *= scalar;
+		return *this;
+	}
+
+	constexpr DualQuaternion &operator*=(const DualQuaternion &other)
+	{
+		*this = *this * other;
+		return *this;
+	}
+
+	constexpr DualQuaternion operator+(const DualQuaternion &other) const
+	{
+		DualQuaternion returnValue = *this;
+		returnValue += other;
+		return returnValue;
+	}
+
+	constexpr DualQuaternion operator*(const ValueType scalar) const
+	{
+		DualQuaternion returnValue = *this;
+		returnValue *= scalar;
+		return returnValue;
+	}
+
+	///
+	/// Composes the transformations, so the product applies \a other first.
+	///
+	constexpr DualQuaternion operator*(const DualQuaternion &other) const
+	{
+		return DualQuaternion{this->_real * other._real, this->_real * other._dual + this->_dual * other._real};
+	}
+
+private:
+	QuaternionType _real = QuaternionType{traits::initialization::zero};
+	QuaternionType _dual = QuaternionType{traits::initialization::zero};
+};
+
+namespace detail
+{
+
+///
+/// Blends the \a bones referenced by \a indices with \a weights for every vertex and applies the normalized blend to \a vertices, writing to
+/// \a result. Points are translated, directions only rotated.
+///
+/// Bone indices and weights are loaded a register of vertices at a time and the eight components of the referenced bones are gathered into
+/// registers by \ref batchGather, so everything runs in vector registers. Each bone is flipped onto the hemisphere of the first one before
+/// blending, so the blend takes the shorter arc between rotations like \ref slerp does.
+///
+template <bool Points, typename Index, typename Weight, std::size_t Influences, typename ValueType, typename Layout>
+inline void skin(const std::span<const DualQuaternion<ValueType>> bones, const VectorSoAView<Index, Influences, Layout> indices,
+				 const VectorSoAView<Weight, Influences, Layout> weights, const typename VectorSoAView<ValueType, 3u, Layout>::ConstView vertices,
+				 const VectorSoAView<ValueType, 3u, Layout> result)
+{
+	static_assert(std::is_integral_v<Index> & std::is_same_v<std::remove_const_t<Weight>, ValueType>, "Invalid bone indices or weights");
+	static_assert(sizeof (DualQuaternion<ValueType>) == (8u * sizeof (ValueType)), "Bones are gathered as eight consecutive components");
+
+	using Mapping = typename VectorSoAView<ValueType, 3u, Layout>::Mapping;
+
+	assert((indices.size() == vertices.size()) & (weights.size() == vertices.size()) & (result.size() == vertices.size()));
+
+	const std::size_t head = detail::batchHead<Mapping>(vertices.size(), vertices.offset(), indices.offset(), weights.offset(), result.offset());
+
+	// The real part is followed by the dual part, so component c of bone i is at 8 i + c
+	const ValueType *source = reinterpret_cast<const ValueType *>(bones.data());
+
+	detail::batch<ValueType, Mapping::lanes>(head, vertices.size(), [source, indices, weights, vertices, result](const std::size_t index, auto lane)
+	{
+		using Lane = decltype(lane);
+
+		Lane real[4u] = {};
+		Lane dual[4u] = {};
+		Lane first[4u] = {};
+
+		for (std::size_t influence = 0u; influence < Influences; ++influence)
+		{
+			const Index *boneIndices = indices.data(influence, index);
+
+			Lane components[8u];
+
+			for (std::size_t component = 0u; component < 8u; ++component)
+			{
+				components[component] = detail::batchGather<8u, Lane>(source + component, boneIndices);
+			}
+
+			Lane weight = detail::batchLoad<Lane>(weights.data(influence, index));
+
+			if (influence == 0u)
+			{
+				for (std::size_t component = 0u; component < 4u; ++component)
+				{
+					first[component] = components[component];
+				}
+			}
+			else
+			{
+				Lane cosine = {};
+
+				for (std::size_t component = 0u; component < 4u; ++component)
+				{
+					cosine += first[component] * components[component];
+				}
+
+				weight = (cosine < ValueType{}) ? Lane{} - weight : weight;
+			}
+
+			for (std::size_t component = 0u; component < 4u; ++component)
+			{
+				real[component] += components[component] * weight;
+				dual[component] += components[component + 4u] * weight;
+			}
+		}
+
+		// The translation below only needs both parts scaled by the norm of the real part, not the orthogonalization of normalize
+		Lane squareNorm = {};
+
+		for (std::size_t component = 0u; component < 4u; ++component)
+		{
+			squareNorm += real[component] * real[component];
+		}
+
+		const Lane scale = ValueType(1) / detail::batchSquareRoot<ValueType>(squareNorm);
+
+		for (std::size_t component = 0u; component < 4u; ++component)
+		{
+			real[component] *= scale;
+			dual[component] *= scale;
+		}
+
+		Lane x = detail::batchLoad<Lane>(vertices.data(0u, index));
+		Lane y = detail::batchLoad<Lane>(vertices.data(1u, index));
+		Lane z = detail::batchLoad<Lane>(vertices.data(2u, index));
+
+		detail::rotate(real[0u], real[1u], real[2u], real[3u], x, y, z);
+
+		if constexpr (Points)
+		{
+			Lane tx;
+			Lane ty;
+			Lane tz;
+			detail::dualQuaternionTranslation(real, dual, tx, ty, tz);
+
+			x += tx;
+			y += ty;
+			z += tz;
+		}
+
+		detail::batchStore(result.data(0u, index), x);
+		detail::batchStore(result.data(1u, index), y);
+		detail::batchStore(result.data(2u, index), z);
+	});
+}
+
+} // namespace detail
+
+///
+/// Writes the points \a points transformed by dual quaternion linear blend skinning to \a result, which may be \a points itself. Every point
+/// is influenced by the \a Influences bones of \a bones its \a indices refer to, with the corresponding \a weights summing to one.
+///
+/// Blending dual quaternions takes eight multiply-adds per influence instead of the twelve of an affine matrix palette, and the normalized
+/// blend is a rigid transformation, so joints neither shear nor collapse like with blended matrices. With 32 bit \a indices the bones are
+/// fetched with gather instructions where available.
+///
+template <typename Index, typename Weight, std::size_t Influences, typename ValueType, typename Layout>
+void skinPoints(const std::span<const std::type_identity_t<DualQuaternion<ValueType>>> bones, const VectorSoAView<Index, Influences, Layout> indices,
+				const VectorSoAView<Weight, Influences, Layout> weights, const typename VectorSoAView<ValueType, 3u, Layout>::ConstView points,
+				const VectorSoAView<ValueType, 3u, Layout> result)
+{
+	detail::skin<true>(bones, indices, weights, points, result);
+}
+
+template <typename Index, std::size_t Influences, typename ValueType, typename Layout>
+void skinPoints(const std::span<const std::type_identity_t<DualQuaternion<ValueType>>> bones, const VectorSoA<Index, Influences, Layout> &indices,
+				const VectorSoA<ValueType, Influences, Layout> &weights, const VectorSoA<ValueType, 3u, Layout> &points,
+				VectorSoA<ValueType, 3u, Layout> &result)
+{
+	skinPoints(bones, indices.view(), weights.view(), points.view(), result.view());
+}
+
+///
+/// Writes the directions \a directions, such as normals, rotated by dual quaternion linear blend skinning to \a result, see \ref skinPoints.
+///
+template <typename Index, typename Weight, std::size_t Influences, typename ValueType, typename Layout>
+void skinDirections(const std::span<const std::type_identity_t<DualQuaternion<ValueType>>> bones,
+					const VectorSoAView<Index, Influences, Layout> indices, const VectorSoAView<Weight, Influences, Layout> weights,
+					const typename VectorSoAView<ValueType, 3u, Layout>::ConstView directions, const VectorSoAView<ValueType, 3u, Layout> result)
+{
+	detail::skin<false>(bones, indices, weights, directions, result);
+}
+
+template <typename Index, std::size_t Influences, typename ValueType, typename Layout>
+void skinDirections(const std::span<const std::type_identity_t<DualQuaternion<ValueType>>> bones, const VectorSoA<Index, Influences, Layout> &indices,
+					const VectorSoA<ValueType, Influences, Layout> &weights, const VectorSoA<ValueType, 3u, Layout> &directions,
+					VectorSoA<ValueType, 3u, Layout> &result)
+{
+	skinDirections(bones, indices.view(), weights.view(), directions.view(), result.view());
+}
+
+using DualQuaternion_f = DualQuaternion<float>;
+using DualQuaternion_d = DualQuaternion<double>;
+
+} // namespace nd::math
+
+#endif // ND_MATH_DUAL_QUATERNION_HPP
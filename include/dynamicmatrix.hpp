@@ -0,0 +1,497 @@
+#ifndef ND_MATH_DYNAMIC_MATRIX_HPP
+#define ND_MATH_DYNAMIC_MATRIX_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+#include "common.hpp"
+#include "execution.hpp"
+#include "gemm.hpp"
+#include "matrix.hpp"
+#include "memory.hpp"
+#include "threadpool.hpp"
+#include "traits.hpp"
+
+namespace nd::math
+{
+
+///
+/// Non-owning view of a row-major matrix whose dimensions are only known at runtime. Rows are \ref stride elements apart.
+///
+/// Views are cheap to copy and are the common currency of the runtime sized kernels: both \ref Matrix and \ref DynamicMatrix can be viewed
+/// without copying their elements. Use a const \a ValueType for read-only views.
+///
+template <typename ValueType>
+class MatrixView
+{
+public:
+	using value_type = std::remove_const_t<ValueType>;
+
+	constexpr MatrixView() = default;
+
+	constexpr MatrixView(ValueType *data, const std::size_t rows, const std::size_t columns) :
+		MatrixView(data, rows, columns, columns)
+	{
+	}
+
+	constexpr MatrixView(ValueType *data, const std::size_t rows, const std::size_t columns, const std::size_t stride) :
+		_data(data),
+		_rows(rows),
+		_columns(columns),
+		_stride(stride)
+	{
+		assert(stride >= columns);
+	}
+
+	template <typename Unused_ = void, typename = std::enable_if_t<std::is_const_v<ValueType>, Unused_>>
+	constexpr MatrixView(const MatrixView<value_type> &other) :
+		MatrixView(other.data(), other.rows(), other.columns(), other.stride())
+	{
+	}
+
+	constexpr ValueType *data() const
+	{
+		return this->_data;
+	}
+
+	constexpr std::size_t rows() const
+	{
+		return this->_rows;
+	}
+
+	constexpr std::size_t columns() const
+	{
+		return this->_columns;
+	}
+
+	constexpr std::size_t stride() const
+	{
+		return this->_stride;
+	}
+
+	constexpr bool isContiguous() const
+	{
+		return (this->_stride == this->_columns);
+	}
+
+	///
+	/// Returns a view of the $rows \times columns$ block starting at row \a row and column \a column.
+	///
+	constexpr MatrixView block(const std::size_t row, const std::size_t column, const std::size_t rows, const std::size_t columns) const
+	{
+		assert(((row + rows) <= this->_rows) & ((column + columns) <= this->_columns));
+		return MatrixView{this->_data + row * this->_stride + column, rows, columns, this->_stride};
+	}
+
+	constexpr ValueType *operator[](const std::size_t row) const
+	{
+		assert(row < this->_rows);
+		return (this->_data + row * this->_stride);
+	}
+
+private:
+	ValueType	*_data		= nullptr;
+	std::size_t	_rows		= 0u;
+	std::size_t	_columns	= 0u;
+	std::size_t	_stride		= 0u;
+};
+
+///
+/// Heap allocated, row-major matrix with dimensions chosen at runtime.
+///
+/// The elements live in a single cache line aligned allocation which is owned exclusively: a DynamicMatrix can be moved but not copied
+/// implicitly, use \ref clone for an explicit deep copy. \ref resize reuses the allocation whenever it is large enough.
+///
+template <typename ValueType>
+class DynamicMatrix
+{
+public:
+	DynamicMatrix() = default;
+
+	DynamicMatrix(const std::size_t rows, const std::size_t columns) :
+		_data(rows * columns),
+		_rows(rows),
+		_columns(columns)
+	{
+	}
+
+	DynamicMatrix(const std::size_t rows, const std::size_t columns, const traits::initialization::Zero) :
+		DynamicMatrix(rows, columns)
+	{
+		this->setZero();
+	}
+
+	DynamicMatrix(const std::size_t rows, const std::size_t columns, const traits::initialization::Identity) :
+		DynamicMatrix(rows, columns)
+	{
+		assert(rows == columns);
+		this->setZero();
+
+		for (std::size_t order = 0u; order < rows; ++order)
+		{
+			(*this)[order][order] = static_cast<ValueType>(1);
+		}
+	}
+
+	template <std::size_t Rows, std::size_t Columns>
+	explicit DynamicMatrix(const Matrix<ValueType, Rows, Columns> &matrix) :
+		DynamicMatrix(Rows, Columns)
+	{
+		common::copy(this->data(), matrix.data(), Rows * Columns);
+	}
+
+	DynamicMatrix(const DynamicMatrix &other) = delete;
+
+	DynamicMatrix(DynamicMatrix &&other) noexcept :
+		_data(std::move(other._data)),
+		_rows(std::exchange(other._rows, 0u)),
+		_columns(std::exchange(other._columns, 0u))
+	{
+	}
+
+	DynamicMatrix &operator=(const DynamicMatrix &other) = delete;
+
+	DynamicMatrix &operator=(DynamicMatrix &&other) noexcept
+	{
+		this->_data		= std::move(other._data);
+		this->_rows		= std::exchange(other._rows, 0u);
+		this->_columns	= std::exchange(other._columns, 0u);
+		return *this;
+	}
+
+	DynamicMatrix clone() const
+	{
+		DynamicMatrix returnValue{this->_rows, this->_columns};
+		common::copy(returnValue.data(), this->data(), this->size());
+		return returnValue;
+	}
+
+	ValueType *data()
+	{
+		return this->_data.data();
+	}
+
+	const ValueType *data() const
+	{
+		return this->_data.data();
+	}
+
+	std::size_t rows() const
+	{
+		return this->_rows;
+	}
+
+	std::size_t columns() const
+	{
+		return this->_columns;
+	}
+
+	std::size_t stride() const
+	{
+		return this->_columns;
+	}
+
+	std::size_t size() const
+	{
+		return this->_rows * this->_columns;
+	}
+
+	///
+	/// Changes the dimensions to $rows \times columns$. The contents are unspecified afterwards; no allocation takes place if the current one
+	/// is large enough.
+	///
+	void resize(const std::size_t rows, const std::size_t columns)
+	{
+		this->_data.reserve(rows * columns);
+		this->_rows		= rows;
+		this->_columns	= columns;
+	}
+
+	void setZero()
+	{
+		common::setZero(this->data(), this->size());
+	}
+
+	MatrixView<ValueType> view()
+	{
+		return MatrixView<ValueType>{this->data(), this->_rows, this->_columns};
+	}
+
+	MatrixView<const ValueType> view() const
+	{
+		return MatrixView<const ValueType>{this->data(), this->_rows, this->_columns};
+	}
+
+	ValueType *operator[](const std::size_t row)
+	{
+		assert(row < this->_rows);
+		return (this->data() + row * this->_columns);
+	}
+
+	const ValueType *operator[](const std::size_t row) const
+	{
+		assert(row < this->_rows);
+		return (this->data() + row * this->_columns);
+	}
+
+	bool operator==(const DynamicMatrix &other) const
+	{
+		return (this->_rows == other._rows) && (this->_columns == other._columns) && common::isEqual(this->data(), other.data(), this->size());
+	}
+
+	bool operator!=(const DynamicMatrix &other) const
+	{
+		return !(*this == other);
+	}
+
+	DynamicMatrix &operator+=(const DynamicMatrix &other)
+	{
+		add(this->view(), this->view(), other.view());
+		return *this;
+	}
+
+	DynamicMatrix &operator-=(const DynamicMatrix &other)
+	{
+		subtract(this->view(), this->view(), other.view());
+		return *this;
+	}
+
+	DynamicMatrix &operator*=(const ValueType scalar)
+	{
+		for (std::size_t index = 0u; index < this->size(); ++index)
+		{
+			this->_data[index] *= scalar;
+		}
+
+		return *this;
+	}
+
+	DynamicMatrix &operator/=(const ValueType scalar)
+	{
+		for (std::size_t index = 0u; index < this->size(); ++index)
+		{
+			this->_data[index] /= scalar;
+		}
+
+		return *this;
+	}
+
+private:
+	memory::AlignedBuffer<ValueType>	_data;
+	std::size_t							_rows		= 0u;
+	std::size_t							_columns	= 0u;
+};
+
+template <typename ValueType, std::size_t Rows, std::size_t Columns>
+constexpr MatrixView<ValueType> view(Matrix<ValueType, Rows, Columns> &matrix)
+{
+	return MatrixView<ValueType>{matrix.data(), Rows, Columns};
+}
+
+template <typename ValueType, std::size_t Rows, std::size_t Columns>
+constexpr MatrixView<const ValueType> view(const Matrix<ValueType, Rows, Columns> &matrix)
+{
+	return MatrixView<const ValueType>{matrix.data(), Rows, Columns};
+}
+
+template <typename ValueType>
+MatrixView<ValueType> view(DynamicMatrix<ValueType> &matrix)
+{
+	return matrix.view();
+}
+
+template <typename ValueType>
+MatrixView<const ValueType> view(const DynamicMatrix<ValueType> &matrix)
+{
+	return matrix.view();
+}
+
+///
+/// Computes the element-wise sum of \a left and \a right into \a result. \a result may alias either operand.
+///
+template <typename ValueType>
+void add(const MatrixView<ValueType> result, const MatrixView<const std::type_identity_t<ValueType>> left,
+		 const MatrixView<const std::type_identity_t<ValueType>> right)
+{
+	assert((left.rows() == right.rows()) & (left.columns() == right.columns()));
+	assert((result.rows() == left.rows()) & (result.columns() == left.columns()));
+
+	for (std::size_t i = 0u; i < result.rows(); ++i)
+	{
+		ValueType		*resultRow	= result[i];
+		const ValueType	*leftRow	= left[i];
+		const ValueType	*rightRow	= right[i];
+
+		for (std::size_t j = 0u; j < result.columns(); ++j)
+		{
+			resultRow[j] = leftRow[j] + rightRow[j];
+		}
+	}
+}
+
+///
+/// Computes the element-wise difference of \a left and \a right into \a result. \a result may alias either operand.
+///
+template <typename ValueType>
+void subtract(const MatrixView<ValueType> result, const MatrixView<const std::type_identity_t<ValueType>> left,
+		 const MatrixView<const std::type_identity_t<ValueType>> right)
+{
+	assert((left.rows() == right.rows()) & (left.columns() == right.columns()));
+	assert((result.rows() == left.rows()) & (result.columns() == left.columns()));
+
+	for (std::size_t i = 0u; i < result.rows(); ++i)
+	{
+		ValueType		*resultRow	= result[i];
+		const ValueType	*leftRow	= left[i];
+		const ValueType	*rightRow	= right[i];
+
+		for (std::size_t j = 0u; j < result.columns(); ++j)
+		{
+			resultRow[j] = leftRow[j] - rightRow[j];
+		}
+	}
+}
+
+///
+/// Computes $C \leftarrow \alpha\,op(A)\,op(B) + \beta C$ into \a result, where $op$ reads \a left and \a right as stored or transposed as
+/// selected by \a leftTransposition and \a rightTransposition. \a result must not alias either operand. Runs on the packed GEMM kernel shared
+///	with \ref Matrix, so no code is generated per dimension and, once the thread local packing buffers are warm, nothing is allocated.
+///
+template <typename ExecutionPolicy, typename ValueType, typename = std::enable_if_t<execution::isExecutionPolicy<ExecutionPolicy>>>
+void gemm([[maybe_unused]] ExecutionPolicy &&policy, const std::type_identity_t<ValueType> alpha,
+		  const MatrixView<const std::type_identity_t<ValueType>> left, const Transposition leftTransposition,
+		  const MatrixView<const std::type_identity_t<ValueType>> right, const Transposition rightTransposition,
+		  const std::type_identity_t<ValueType> beta, const MatrixView<ValueType> result)
+{
+	using Blocking = detail::GemmBlocking<ValueType>;
+
+	const bool			leftTransposed	= (leftTransposition == Transposition::transpose);
+	const bool			rightTransposed	= (rightTransposition == Transposition::transpose);
+	const std::size_t	m				= leftTransposed ? left.columns() : left.rows();
+	const std::size_t	k				= leftTransposed ? left.rows() : left.columns();
+	const std::size_t	n				= rightTransposed ? right.rows() : right.columns();
+
+	assert((rightTransposed ? right.columns() : right.rows()) == k);
+	assert((result.rows() == m) & (result.columns() == n));
+
+	const auto leftOperand	= detail::GemmOperand<ValueType>::make(left.data(), left.stride(), leftTransposed);
+	const auto rightOperand	= detail::GemmOperand<ValueType>::make(right.data(), right.stride(), rightTransposed);
+
+	const std::size_t flop = m * n * k;
+
+	if constexpr (Blocking::supported)
+	{
+		if (flop >= Blocking::threshold)
+		{
+			if (execution::isParallelPolicy<ExecutionPolicy> & (flop >= Blocking::parallelThreshold))
+			{
+				detail::gemmParallel<Blocking>(ThreadPool::instance(), m, n, k, alpha, leftOperand, rightOperand, beta, result.data(), result.stride());
+			}
+			else
+			{
+				detail::gemm<Blocking>(m, n, k, alpha, leftOperand, rightOperand, beta, result.data(), result.stride());
+			}
+
+			return;
+		}
+	}
+
+	detail::gemmReference(m, n, k, alpha, leftOperand, rightOperand, beta, result.data(), result.stride());
+}
+
+template <typename ValueType>
+void gemm(const std::type_identity_t<ValueType> alpha, const MatrixView<const std::type_identity_t<ValueType>> left,
+		  const Transposition leftTransposition, const MatrixView<const std::type_identity_t<ValueType>> right,
+		  const Transposition rightTransposition, const std::type_identity_t<ValueType> beta, const MatrixView<ValueType> result)
+{
+	gemm(execution::seq, alpha, left, leftTransposition, right, rightTransposition, beta, result);
+}
+
+///
+/// Computes the product of \a left and \a right into \a result, which must not alias either operand.
+///
+template <typename ExecutionPolicy, typename ValueType, typename = std::enable_if_t<execution::isExecutionPolicy<ExecutionPolicy>>>
+void mul(ExecutionPolicy &&policy, const MatrixView<ValueType> result, const MatrixView<const std::type_identity_t<ValueType>> left,
+		 const MatrixView<const std::type_identity_t<ValueType>> right)
+{
+	gemm(std::forward<ExecutionPolicy>(policy), ValueType{1}, left, Transposition::none, right, Transposition::none, ValueType{}, result);
+}
+
+template <typename ValueType>
+void mul(const MatrixView<ValueType> result, const MatrixView<const std::type_identity_t<ValueType>> left,
+		 const MatrixView<const std::type_identity_t<ValueType>> right)
+{
+	mul(execution::seq, result, left, right);
+}
+
+template <typename ExecutionPolicy, typename ValueType, typename = std::enable_if_t<execution::isExecutionPolicy<ExecutionPolicy>>>
+void mul(ExecutionPolicy &&policy, DynamicMatrix<ValueType> &result, const DynamicMatrix<ValueType> &left, const DynamicMatrix<ValueType> &right)
+{
+	mul(std::forward<ExecutionPolicy>(policy), result.view(), left.view(), right.view());
+}
+
+template <typename ValueType>
+void mul(DynamicMatrix<ValueType> &result, const DynamicMatrix<ValueType> &left, const DynamicMatrix<ValueType> &right)
+{
+	mul(execution::seq, result.view(), left.view(), right.view());
+}
+
+template <typename ValueType>
+DynamicMatrix<ValueType> operator*(const DynamicMatrix<ValueType> &left, const DynamicMatrix<ValueType> &right)
+{
+	DynamicMatrix<ValueType> returnValue{left.rows(), right.columns()};
+
+	mul(returnValue, left, right);
+
+	return returnValue;
+}
+
+template <typename ValueType>
+DynamicMatrix<ValueType> operator+(const DynamicMatrix<ValueType> &left, const DynamicMatrix<ValueType> &right)
+{
+	DynamicMatrix<ValueType> returnValue{left.rows(), left.columns()};
+
+	add(returnValue.view(), left.view(), right.view());
+
+	return returnValue;
+}
+
+template <typename ValueType>
+DynamicMatrix<ValueType> operator-(const DynamicMatrix<ValueType> &left, const DynamicMatrix<ValueType> &right)
+{
+	DynamicMatrix<ValueType> returnValue{left.rows(), left.columns()};
+
+	subtract(returnValue.view(), left.view(), right.view());
+
+	return returnValue;
+}
+
+template <typename ValueType>
+std::ostream &operator<<(std::ostream &stream, const DynamicMatrix<ValueType> &matrix)
+{
+	for (std::size_t i = 0u; i < matrix.rows(); ++i)
+	{
+		for (std::size_t j = 0u; j < matrix.columns(); ++j)
+		{
+			stream << std::to_string(matrix[i][j]) << " ";
+		}
+
+		if (i != matrix.rows() - 1u)
+		{
+			stream << "\n";
+		}
+	}
+
+	return stream;
+}
+
+using DynamicMatrix_f	= DynamicMatrix<float>;
+using DynamicMatrix_d	= DynamicMatrix<double>;
+
+} // namespace nd::math
+
+#endif // ND_MATH_DYNAMIC_MATRIX_HPP
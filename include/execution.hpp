@@ -0,0 +1,34 @@
+#ifndef ND_MATH_EXECUTION_HPP
+#define ND_MATH_EXECUTION_HPP
+
+#include <type_traits>
+
+namespace nd::math::execution
+{
+
+///
+/// Execution policy that runs an algorithm on the calling thread.
+///
+struct SequencedPolicy {};
+
+///
+/// Execution policy that distributes an algorithm across the ndmath thread pool.
+///
+struct ParallelPolicy {};
+
+inline constexpr SequencedPolicy	seq	= SequencedPolicy{};
+inline constexpr ParallelPolicy		par	= ParallelPolicy{};
+
+template <typename Policy>
+struct IsExecutionPolicy : std::disjunction<std::is_same<std::remove_cvref_t<Policy>, SequencedPolicy>,
+											std::is_same<std::remove_cvref_t<Policy>, ParallelPolicy>> {};
+
+template <typename Policy>
+inline constexpr bool isExecutionPolicy = IsExecutionPolicy<Policy>::value;
+
+template <typename Policy>
+inline constexpr bool isParallelPolicy = std::is_same_v<std::remove_cvref_t<Policy>, ParallelPolicy>;
+
+} // namespace nd::math::execution
+
+#endif // ND_MATH_EXECUTION_HPP
@@ -0,0 +1,231 @@
+#ifndef ND_MATH_EXPRESSION_HPP
+#define ND_MATH_EXPRESSION_HPP
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <type_traits>
+
+#include "traits.hpp"
+
+namespace nd::math
+{
+
+template <
+	typename ValueType,
+	std::size_t			Rows,
+	std::size_t			Columns>
+class Matrix;
+
+///
+/// Base of all element-wise matrix expressions.
+///
+/// The arithmetic operators of \ref Matrix do not compute their result immediately but return lightweight expression nodes. A tree of nodes is
+/// evaluated in a single loop once it is assigned to a \ref Matrix, so an expression like \f$a + b s - c\f$ neither creates temporaries nor
+/// passes over memory more than once. Nodes reference their matrix operands, so an expression must be evaluated before its operands go out of
+/// scope; store results in a \ref Matrix rather than in \c auto variables.
+///
+template <
+	typename Expression,
+	typename ValueType,
+	std::size_t			Rows,
+	std::size_t			Columns>
+class MatrixExpression
+{
+public:
+	constexpr const Expression &expression() const
+	{
+		return static_cast<const Expression &>(*this);
+	}
+
+	///
+	/// Returns the element at the row-major position \a index.
+	///
+	constexpr ValueType element(const std::size_t index) const
+	{
+		return this->expression().element(index);
+	}
+
+	constexpr Matrix<ValueType, Rows, Columns> eval() const
+	{
+		return Matrix<ValueType, Rows, Columns>{*this};
+	}
+
+	template <typename Unused_ = void, typename = traits::EnableVector<Rows, Columns, Unused_>>
+	constexpr ValueType operator[](const std::size_t index) const
+	{
+		return this->element(index);
+	}
+
+	constexpr Matrix<ValueType, Columns, Rows> transposed() const
+	{
+		return this->eval().transposed();
+	}
+
+	template <typename Unused_ = void, typename = traits::EnableVector<Rows, Columns, Unused_>>
+	constexpr ValueType squareNorm() const
+	{
+		return this->eval().squareNorm();
+	}
+
+	template <typename Unused_ = void, typename = traits::EnableVector<Rows, Columns, Unused_>>
+	constexpr ValueType norm() const
+	{
+		return this->eval().norm();
+	}
+
+	template <typename Unused_ = void, typename = traits::EnableVector<Rows, Columns, Unused_>>
+	constexpr Matrix<ValueType, Rows, Columns> normalized() const
+	{
+		return this->eval().normalized();
+	}
+
+	template <typename Unused_ = void, typename = traits::Enable3DVector<Rows, Columns, Unused_>>
+	constexpr Matrix<ValueType, Rows, Columns> cross(const Matrix<ValueType, Rows, Columns> &other) const
+	{
+		return this->eval().cross(other);
+	}
+};
+
+namespace detail
+{
+
+template <typename Expression>
+struct IsMatrix : std::false_type {};
+
+template <typename ValueType, std::size_t Rows, std::size_t Columns>
+struct IsMatrix<Matrix<ValueType, Rows, Columns>> : std::true_type {};
+
+///
+/// Matrices are held by reference, nested expression nodes by value since they usually are temporaries.
+///
+template <typename Expression>
+using ExpressionOperand = std::conditional_t<IsMatrix<Expression>::value, const Expression &, const Expression>;
+
+} // namespace detail
+
+template <
+	typename Operation,
+	typename Left,
+	typename Right,
+	typename ValueType,
+	std::size_t			Rows,
+	std::size_t			Columns>
+class MatrixBinaryExpression : public MatrixExpression<MatrixBinaryExpression<Operation, Left, Right, ValueType, Rows, Columns>, ValueType, Rows, Columns>
+{
+public:
+	constexpr MatrixBinaryExpression(const Left &left, const Right &right) :
+		_left(left),
+		_right(right)
+	{
+	}
+
+	constexpr ValueType element(const std::size_t index) const
+	{
+		return Operation{}(this->_left.element(index), this->_right.element(index));
+	}
+
+private:
+	detail::ExpressionOperand<Left>		_left;
+	detail::ExpressionOperand<Right>	_right;
+};
+
+template <
+	typename Operation,
+	typename Operand,
+	typename ValueType,
+	std::size_t			Rows,
+	std::size_t			Columns>
+class MatrixScalarExpression : public MatrixExpression<MatrixScalarExpression<Operation, Operand, ValueType, Rows, Columns>, ValueType, Rows, Columns>
+{
+public:
+	constexpr MatrixScalarExpression(const Operand &operand, const ValueType scalar) :
+		_operand(operand),
+		_scalar(scalar)
+	{
+	}
+
+	constexpr ValueType element(const std::size_t index) const
+	{
+		return Operation{}(this->_operand.element(index), this->_scalar);
+	}
+
+private:
+	detail::ExpressionOperand<Operand>	_operand;
+	ValueType							_scalar;
+};
+
+template <
+	typename Operation,
+	typename Operand,
+	typename ValueType,
+	std::size_t			Rows,
+	std::size_t			Columns>
+class MatrixUnaryExpression : public MatrixExpression<MatrixUnaryExpression<Operation, Operand, ValueType, Rows, Columns>, ValueType, Rows, Columns>
+{
+public:
+	constexpr explicit MatrixUnaryExpression(const Operand &operand) :
+		_operand(operand)
+	{
+	}
+
+	constexpr ValueType element(const std::size_t index) const
+	{
+		return Operation{}(this->_operand.element(index));
+	}
+
+private:
+	detail::ExpressionOperand<Operand> _operand;
+};
+
+template <typename Left, typename Right, typename ValueType, std::size_t Rows, std::size_t Columns>
+constexpr MatrixBinaryExpression<std::plus<>, Left, Right, ValueType, Rows, Columns> operator+(const MatrixExpression<Left, ValueType, Rows, Columns> &left,
+																							   const MatrixExpression<Right, ValueType, Rows, Columns> &right)
+{
+	return {left.expression(), right.expression()};
+}
+
+template <typename Left, typename Right, typename ValueType, std::size_t Rows, std::size_t Columns>
+constexpr MatrixBinaryExpression<std::minus<>, Left, Right, ValueType, Rows, Columns> operator-(const MatrixExpression<Left, ValueType, Rows, Columns> &left,
+																								const MatrixExpression<Right, ValueType, Rows, Columns> &right)
+{
+	return {left.expression(), right.expression()};
+}
+
+template <typename Operand, typename ValueType, std::size_t Rows, std::size_t Columns>
+constexpr MatrixScalarExpression<std::multiplies<>, Operand, ValueType, Rows, Columns> operator*(const MatrixExpression<Operand, ValueType, Rows, Columns> &matrix,
+																								 const std::type_identity_t<ValueType> scalar)
+{
+	return {matrix.expression(), scalar};
+}
+
+template <typename Operand, typename ValueType, std::size_t Rows, std::size_t Columns>
+constexpr MatrixScalarExpression<std::multiplies<>, Operand, ValueType, Rows, Columns> operator*(const std::type_identity_t<ValueType> scalar,
+																								 const MatrixExpression<Operand, ValueType, Rows, Columns> &matrix)
+{
+	return {matrix.expression(), scalar};
+}
+
+template <typename Operand, typename ValueType, std::size_t Rows, std::size_t Columns>
+constexpr MatrixScalarExpression<std::divides<>, Operand, ValueType, Rows, Columns> operator/(const MatrixExpression<Operand, ValueType, Rows, Columns> &matrix,
+																							  const std::type_identity_t<ValueType> scalar)
+{
+	return {matrix.expression(), scalar};
+}
+
+template <typename Operand, typename ValueType, std::size_t Rows, std::size_t Columns, typename = traits::EnableNegative<ValueType, void>>
+constexpr MatrixUnaryExpression<std::negate<>, Operand, ValueType, Rows, Columns> operator-(const MatrixExpression<Operand, ValueType, Rows, Columns> &matrix)
+{
+	return MatrixUnaryExpression<std::negate<>, Operand, ValueType, Rows, Columns>{matrix.expression()};
+}
+
+template <typename Expression, typename ValueType, std::size_t Rows, std::size_t Columns,
+		  typename = std::enable_if_t<!detail::IsMatrix<Expression>::value>>
+std::ostream &operator<<(std::ostream &stream, const MatrixExpression<Expression, ValueType, Rows, Columns> &expression)
+{
+	return (stream << expression.eval());
+}
+
+} // namespace nd::math
+
+#endif // ND_MATH_EXPRESSION_HPP
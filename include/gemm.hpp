@@ -0,0 +1,573 @@
+#ifndef ND_MATH_GEMM_HPP
+#define ND_MATH_GEMM_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "memory.hpp"
+#include "simd.hpp"
+#include "threadpool.hpp"
+
+namespace nd::math::detail
+{
+
+inline constexpr std::size_t roundUp(const std::size_t value, const std::size_t multiple)
+{
+	return ((value + multiple - 1u) / multiple) * multiple;
+}
+
+///
+/// Rounds \a value down to a multiple of \a multiple, but never below \a multiple itself, so a block size derived from a small cache is still
+/// at least one micro-tile.
+///
+inline constexpr std::size_t roundDownAtLeast(const std::size_t value, const std::size_t multiple)
+{
+	return std::max((value / multiple) * multiple, multiple);
+}
+
+///
+/// Blocking parameters of the packed GEMM kernel for a product of a $L \times M$ and a $M \times N$ matrix.
+///
+/// The micro-tile of $mr \times nr$ accumulators is sized to occupy most of the vector registers, the $kc \times nr$ micro-panel of the right
+/// operand is kept in half of the L1 cache and the $mc \times kc$ block of the left operand in half of the L2 cache. Block sizes are clamped to
+///	the (compile-time) dimensions so small products do not pack more than needed. A dimension of zero means it is only known at runtime.
+///
+template <typename ValueType, std::size_t L = 0u, std::size_t M = 0u, std::size_t N = 0u>
+struct GemmBlocking
+{
+private:
+	static constexpr std::size_t limit(const std::size_t value, const std::size_t dimension, const std::size_t granularity)
+	{
+		return (dimension == 0u) ? value : std::min(value, roundUp(dimension, granularity));
+	}
+
+public:
+	static constexpr std::size_t nr	= 2u * simd::width<ValueType>;
+	static constexpr std::size_t mr	= (simd::registerCount - 4u) / 2u;
+	static constexpr std::size_t kc	= limit(roundDownAtLeast(simd::l1CacheSize / 2u / (nr * sizeof (ValueType)), 8u), M, 1u);
+	static constexpr std::size_t mc	= limit(roundDownAtLeast(simd::l2CacheSize / 2u / (kc * sizeof (ValueType)), mr), L, mr);
+	static constexpr std::size_t nc	= limit(4096u, N, nr);
+
+	///
+	/// The packed kernel is implemented for floating point and integral elements only.
+	///
+	static constexpr bool supported	= std::is_same_v<ValueType, float> | std::is_same_v<ValueType, double> |
+									  (std::is_integral_v<ValueType> & !std::is_same_v<ValueType, bool>);
+
+	///
+	/// Packing only pays off once the operands no longer fit into the L1 cache; tiny products stay on the reference loop.
+	///
+	static constexpr std::size_t	threshold			= 32u * 32u * 32u;
+	static constexpr bool			enabled				= supported & ((L * M * N) >= threshold);
+
+	///
+	/// Distributing tiles across threads only pays off for products that take well beyond the cost of waking the workers.
+	///
+	static constexpr std::size_t	parallelThreshold	= 128u * 128u * 128u;
+	static constexpr bool			parallel			= enabled & ((L * M * N) >= parallelThreshold);
+};
+
+#if defined(__GNUC__)
+template <typename ValueType>
+using VectorRegister __attribute__ ((vector_size (simd::registerSize))) = ValueType;
+#endif
+
+///
+/// Row-major or transposed operand of the packed kernel: element $(i, j)$ lives at $data[i \cdot rowStride + j \cdot columnStride]$, so a
+/// transposed operand is read in place by swapping the strides.
+///
+template <typename ValueType>
+struct GemmOperand
+{
+	const ValueType	*data			= nullptr;
+	std::size_t		rowStride		= 0u;
+	std::size_t		columnStride	= 1u;
+
+	///
+	/// Describes the row-major matrix at \a data with rows \a stride elements apart, read as its transpose if \a transposed is set.
+	///
+	static constexpr GemmOperand make(const ValueType *data, const std::size_t stride, const bool transposed)
+	{
+		return transposed ? GemmOperand{data, 1u, stride} : GemmOperand{data, stride, 1u};
+	}
+
+	constexpr const ValueType *at(const std::size_t row, const std::size_t column) const
+	{
+		return this->data + row * this->rowStride + column * this->columnStride;
+	}
+
+	constexpr GemmOperand offset(const std::size_t row, const std::size_t column) const
+	{
+		return GemmOperand{this->at(row, column), this->rowStride, this->columnStride};
+	}
+};
+
+///
+/// Copies the $rows \times depth$ block \a source into slivers of \a MR rows, stored column by column and scaled by \a alpha. Rows past the
+/// edge are zero filled.
+///
+template <std::size_t MR, typename ValueType>
+inline void gemmPackLeft(const std::size_t rows, const std::size_t depth, const ValueType alpha, const GemmOperand<ValueType> source,
+						 ValueType *destination)
+{
+	for (std::size_t sliver = 0u; sliver < rows; sliver += MR)
+	{
+		const std::size_t sliverRows = std::min(MR, rows - sliver);
+
+		for (std::size_t p = 0u; p < depth; ++p)
+		{
+			const ValueType *column = source.at(sliver, p);
+
+			for (std::size_t i = 0u; i < sliverRows; ++i)
+			{
+				destination[i] = alpha * column[i * source.rowStride];
+			}
+
+			for (std::size_t i = sliverRows; i < MR; ++i)
+			{
+				destination[i] = {};
+			}
+
+			destination += MR;
+		}
+	}
+}
+
+///
+/// Copies the $depth \times columns$ block \a source into slivers of \a NR columns, stored row by row. Columns past the edge are zero filled.
+///
+template <std::size_t NR, typename ValueType>
+inline void gemmPackRight(const std::size_t depth, const std::size_t columns, const GemmOperand<ValueType> source, ValueType *destination)
+{
+	for (std::size_t sliver = 0u; sliver < columns; sliver += NR)
+	{
+		const std::size_t sliverColumns = std::min(NR, columns - sliver);
+
+		for (std::size_t p = 0u; p < depth; ++p)
+		{
+			const ValueType *row = source.at(p, sliver);
+
+			if (source.columnStride == 1u)
+			{
+				for (std::size_t j = 0u; j < sliverColumns; ++j)
+				{
+					destination[j] = row[j];
+				}
+			}
+			else
+			{
+				for (std::size_t j = 0u; j < sliverColumns; ++j)
+				{
+					destination[j] = row[j * source.columnStride];
+				}
+			}
+
+			for (std::size_t j = sliverColumns; j < NR; ++j)
+			{
+				destination[j] = {};
+			}
+
+			destination += NR;
+		}
+	}
+}
+
+///
+/// Computes the product of a packed \a MR row sliver and a packed \a NR column sliver and stores it into the $rows \times columns$ tile at
+/// \a result, which is scaled by \a beta first. A \a beta of zero overwrites the tile without reading it.
+///
+template <std::size_t MR, std::size_t NR, typename ValueType>
+inline void gemmMicroKernel(const std::size_t depth, const ValueType *left, const ValueType *right, const ValueType beta, ValueType *result,
+							const std::size_t stride, const std::size_t rows, const std::size_t columns)
+{
+	ValueType tile[MR][NR];
+
+#if defined(__GNUC__)
+	using Register = VectorRegister<ValueType>;
+	constexpr std::size_t lanes				= simd::width<ValueType>;
+	constexpr std::size_t columnRegisters	= NR / lanes;
+	static_assert((NR % lanes) == 0u);
+
+	Register accumulators[MR][columnRegisters] = {};
+
+	for (std::size_t p = 0u; p < depth; ++p)
+	{
+		Register rightRegisters[columnRegisters];
+
+#pragma GCC unroll 4
+		for (std::size_t j = 0u; j < columnRegisters; ++j)
+		{
+			std::memcpy(&rightRegisters[j], right + j * lanes, sizeof (Register));
+		}
+
+#pragma GCC unroll 16
+		for (std::size_t i = 0u; i < MR; ++i)
+		{
+			const Register broadcast = Register{} + left[i];
+
+#pragma GCC unroll 4
+			for (std::size_t j = 0u; j < columnRegisters; ++j)
+			{
+				accumulators[i][j] += broadcast * rightRegisters[j];
+			}
+		}
+
+		left	+= MR;
+		right	+= NR;
+	}
+
+	std::memcpy(tile, accumulators, sizeof (tile));
+#else
+	for (std::size_t i = 0u; i < MR; ++i)
+	{
+		for (std::size_t j = 0u; j < NR; ++j)
+		{
+			tile[i][j] = {};
+		}
+	}
+
+	for (std::size_t p = 0u; p < depth; ++p)
+	{
+		for (std::size_t i = 0u; i < MR; ++i)
+		{
+			for (std::size_t j = 0u; j < NR; ++j)
+			{
+				tile[i][j] += left[i] * right[j];
+			}
+		}
+
+		left	+= MR;
+		right	+= NR;
+	}
+#endif
+
+	if (beta == ValueType{1})
+	{
+		for (std::size_t i = 0u; i < rows; ++i)
+		{
+			for (std::size_t j = 0u; j < columns; ++j)
+			{
+				result[i * stride + j] += tile[i][j];
+			}
+		}
+	}
+	else if (beta == ValueType{})
+	{
+		for (std::size_t i = 0u; i < rows; ++i)
+		{
+			for (std::size_t j = 0u; j < columns; ++j)
+			{
+				result[i * stride + j] = tile[i][j];
+			}
+		}
+	}
+	else
+	{
+		for (std::size_t i = 0u; i < rows; ++i)
+		{
+			for (std::size_t j = 0u; j < columns; ++j)
+			{
+				result[i * stride + j] = beta * result[i * stride + j] + tile[i][j];
+			}
+		}
+	}
+}
+
+///
+/// Computes $C \leftarrow \beta C$ for the $m \times n$ matrix \a result, without reading it if \a beta is zero.
+///
+template <typename ValueType>
+inline constexpr void gemmScale(const std::size_t m, const std::size_t n, const ValueType beta, ValueType *result, const std::size_t resultStride)
+{
+	if (beta == ValueType{1})
+	{
+		return;
+	}
+
+	for (std::size_t i = 0u; i < m; ++i)
+	{
+		for (std::size_t j = 0u; j < n; ++j)
+		{
+			result[i * resultStride + j] = (beta == ValueType{}) ? ValueType{} : beta * result[i * resultStride + j];
+		}
+	}
+}
+
+///
+/// Reference implementation of \ref gemm for tiny products, unsupported element types and constant evaluation.
+///
+template <typename ValueType>
+inline constexpr void gemmReference(const std::size_t m, const std::size_t n, const std::size_t k,
+									const ValueType alpha, const GemmOperand<ValueType> left, const GemmOperand<ValueType> right,
+									const ValueType beta, ValueType *result, const std::size_t resultStride)
+{
+	gemmScale(m, n, beta, result, resultStride);
+
+	for (std::size_t i = 0u; i < m; ++i)
+	{
+		ValueType * const resultRow = result + i * resultStride;
+
+		for (std::size_t p = 0u; p < k; ++p)
+		{
+			const ValueType			leftValue	= alpha * *left.at(i, p);
+			const ValueType * const	rightRow	= right.at(p, 0u);
+
+			for (std::size_t j = 0u; j < n; ++j)
+			{
+				resultRow[j] += leftValue * rightRow[j * right.columnStride];
+			}
+		}
+	}
+}
+
+///
+/// Computes $C \leftarrow \alpha A B + \beta C$ for the $m \times k$ operand \a left, the $k \times n$ operand \a right and the row-major
+/// $m \times n$ matrix \a result using the blocking parameters \a Blocking. Either operand may be read transposed, see \ref GemmOperand.
+///
+/// The operands are packed into thread local buffers so repeated calls do not allocate. \a alpha is applied while packing \a left and \a beta
+/// while storing the first depth block, so neither costs an extra pass over memory. A \a beta of zero never reads \a result.
+///
+template <typename Blocking, typename ValueType>
+inline void gemm(const std::size_t m, const std::size_t n, const std::size_t k,
+				 const ValueType alpha, const GemmOperand<ValueType> left, const GemmOperand<ValueType> right,
+				 const ValueType beta, ValueType *result, const std::size_t resultStride)
+{
+	constexpr std::size_t mr = Blocking::mr;
+	constexpr std::size_t nr = Blocking::nr;
+	constexpr std::size_t mc = Blocking::mc;
+	constexpr std::size_t kc = Blocking::kc;
+	constexpr std::size_t nc = Blocking::nc;
+
+	if (k == 0u)
+	{
+		gemmScale(m, n, beta, result, resultStride);
+		return;
+	}
+
+	ValueType *packedLeft	= memory::scratch<ValueType, 0u>(roundUp(mc, mr) * kc);
+	ValueType *packedRight	= memory::scratch<ValueType, 1u>(kc * roundUp(nc, nr));
+
+	for (std::size_t jc = 0u; jc < n; jc += nc)
+	{
+		const std::size_t columns = std::min(nc, n - jc);
+
+		for (std::size_t pc = 0u; pc < k; pc += kc)
+		{
+			const std::size_t	depth		= std::min(kc, k - pc);
+			const ValueType		blockBeta	= (pc == 0u) ? beta : ValueType{1};
+
+			gemmPackRight<nr>(depth, columns, right.offset(pc, jc), packedRight);
+
+			for (std::size_t ic = 0u; ic < m; ic += mc)
+			{
+				const std::size_t rows = std::min(mc, m - ic);
+
+				gemmPackLeft<mr>(rows, depth, alpha, left.offset(ic, pc), packedLeft);
+
+				for (std::size_t jr = 0u; jr < columns; jr += nr)
+				{
+					for (std::size_t ir = 0u; ir < rows; ir += mr)
+					{
+						gemmMicroKernel<mr, nr>(depth, packedLeft + ir * depth, packedRight + jr * depth, blockBeta,
+												result + (ic + ir) * resultStride + jc + jr, resultStride,
+												std::min(mr, rows - ir), std::min(nr, columns - jr));
+					}
+				}
+			}
+		}
+	}
+}
+
+///
+/// Computes $C \mathrel{+}= A B$ for the row-major $m \times k$ matrix \a left, the $k \times n$ matrix \a right and the $m \times n$ matrix
+/// \a result using the blocking parameters \a Blocking.
+///
+template <typename Blocking, typename ValueType>
+inline void gemm(const std::size_t m, const std::size_t n, const std::size_t k,
+				 const ValueType *left, const std::size_t leftStride,
+				 const ValueType *right, const std::size_t rightStride,
+				 ValueType *result, const std::size_t resultStride)
+{
+	gemm<Blocking>(m, n, k, ValueType{1}, GemmOperand<ValueType>{left, leftStride}, GemmOperand<ValueType>{right, rightStride},
+				   ValueType{1}, result, resultStride);
+}
+
+///
+/// Parallel variant of \ref gemm. The result is split into tiles of whole \a mc row blocks and \a nr aligned column ranges, which are
+/// distributed across \a pool. Every thread packs into its own scratch buffers.
+///
+template <typename Blocking, typename ValueType>
+inline void gemmParallel(ThreadPool &pool, const std::size_t m, const std::size_t n, const std::size_t k,
+						 const ValueType alpha, const GemmOperand<ValueType> left, const GemmOperand<ValueType> right,
+						 const ValueType beta, ValueType *result, const std::size_t resultStride)
+{
+	constexpr std::size_t	tasksPerThread	= 4u;
+	const std::size_t		rowTile			= Blocking::mc;
+	const std::size_t		rowTiles		= (m + rowTile - 1u) / rowTile;
+	const std::size_t		columnSlivers	= (n + Blocking::nr - 1u) / Blocking::nr;
+	const std::size_t		columnTiles		= std::clamp((tasksPerThread * pool.concurrency() + rowTiles - 1u) / rowTiles,
+														 std::size_t{1u}, columnSlivers);
+	const std::size_t		columnTile		= roundUp((n + columnTiles - 1u) / columnTiles, Blocking::nr);
+
+	pool.parallelFor(rowTiles * columnTiles, [=](const std::size_t tile)
+	{
+		const std::size_t row		= (tile / columnTiles) * rowTile;
+		const std::size_t column	= (tile % columnTiles) * columnTile;
+
+		if (column < n)
+		{
+			gemm<Blocking>(std::min(rowTile, m - row), std::min(columnTile, n - column), k,
+						   alpha, left.offset(row, 0u), right.offset(0u, column),
+						   beta, result + row * resultStride + column, resultStride);
+		}
+	});
+}
+
+template <typename Blocking, typename ValueType>
+inline void gemmParallel(ThreadPool &pool, const std::size_t m, const std::size_t n, const std::size_t k,
+						 const ValueType *left, const std::size_t leftStride,
+						 const ValueType *right, const std::size_t rightStride,
+						 ValueType *result, const std::size_t resultStride)
+{
+	gemmParallel<Blocking>(pool, m, n, k, ValueType{1}, GemmOperand<ValueType>{left, leftStride}, GemmOperand<ValueType>{right, rightStride},
+						   ValueType{1}, result, resultStride);
+}
+
+///
+/// True if a hand-vectorized kernel exists for the product of a $L \times M$ and a $M \times N$ matrix of \a ValueType. Covers the 4x4 matrix
+/// product, the 4x4 matrix-column vector product and the row vector-4x4 matrix product.
+///
+template <typename ValueType, std::size_t L, std::size_t M, std::size_t N>
+inline constexpr bool hasMul4Kernel =
+#if defined(ND_MATH_SIMD_AVX)
+	(std::is_same_v<ValueType, float> | std::is_same_v<ValueType, double>) &
+#elif defined(ND_MATH_SIMD_SSE)
+	std::is_same_v<ValueType, float> &
+#else
+	false &
+#endif
+	(M == 4u) & (((L == 4u) & (N == 4u)) | ((L == 4u) & (N == 1u)) | ((L == 1u) & (N == 4u)));
+
+#if defined(ND_MATH_SIMD_SSE)
+inline void mul4x4x4(float *result, const float *left, const float *right)
+{
+	const __m128 right0 = _mm_loadu_ps(right);
+	const __m128 right1 = _mm_loadu_ps(right + 4u);
+	const __m128 right2 = _mm_loadu_ps(right + 8u);
+	const __m128 right3 = _mm_loadu_ps(right + 12u);
+
+	for (std::size_t i = 0u; i < 4u; ++i)
+	{
+		__m128 row	= _mm_mul_ps(_mm_set1_ps(left[i * 4u]), right0);
+		row			= simd::multiplyAdd(_mm_set1_ps(left[i * 4u + 1u]), right1, row);
+		row			= simd::multiplyAdd(_mm_set1_ps(left[i * 4u + 2u]), right2, row);
+		row			= simd::multiplyAdd(_mm_set1_ps(left[i * 4u + 3u]), right3, row);
+		_mm_storeu_ps(result + i * 4u, row);
+	}
+}
+
+inline void mul4x4x1(float *result, const float *left, const float *right)
+{
+	__m128 column0 = _mm_loadu_ps(left);
+	__m128 column1 = _mm_loadu_ps(left + 4u);
+	__m128 column2 = _mm_loadu_ps(left + 8u);
+	__m128 column3 = _mm_loadu_ps(left + 12u);
+
+	_MM_TRANSPOSE4_PS(column0, column1, column2, column3);
+
+	__m128 vector	= _mm_mul_ps(column0, _mm_set1_ps(right[0u]));
+	vector			= simd::multiplyAdd(column1, _mm_set1_ps(right[1u]), vector);
+	vector			= simd::multiplyAdd(column2, _mm_set1_ps(right[2u]), vector);
+	vector			= simd::multiplyAdd(column3, _mm_set1_ps(right[3u]), vector);
+	_mm_storeu_ps(result, vector);
+}
+
+inline void mul1x4x4(float *result, const float *left, const float *right)
+{
+	__m128 vector	= _mm_mul_ps(_mm_set1_ps(left[0u]), _mm_loadu_ps(right));
+	vector			= simd::multiplyAdd(_mm_set1_ps(left[1u]), _mm_loadu_ps(right + 4u), vector);
+	vector			= simd::multiplyAdd(_mm_set1_ps(left[2u]), _mm_loadu_ps(right + 8u), vector);
+	vector			= simd::multiplyAdd(_mm_set1_ps(left[3u]), _mm_loadu_ps(right + 12u), vector);
+	_mm_storeu_ps(result, vector);
+}
+#endif
+
+#if defined(ND_MATH_SIMD_AVX)
+inline void mul4x4x4(double *result, const double *left, const double *right)
+{
+	const __m256d right0 = _mm256_loadu_pd(right);
+	const __m256d right1 = _mm256_loadu_pd(right + 4u);
+	const __m256d right2 = _mm256_loadu_pd(right + 8u);
+	const __m256d right3 = _mm256_loadu_pd(right + 12u);
+
+	for (std::size_t i = 0u; i < 4u; ++i)
+	{
+		__m256d row	= _mm256_mul_pd(_mm256_broadcast_sd(left + i * 4u), right0);
+		row			= simd::multiplyAdd(_mm256_broadcast_sd(left + i * 4u + 1u), right1, row);
+		row			= simd::multiplyAdd(_mm256_broadcast_sd(left + i * 4u + 2u), right2, row);
+		row			= simd::multiplyAdd(_mm256_broadcast_sd(left + i * 4u + 3u), right3, row);
+		_mm256_storeu_pd(result + i * 4u, row);
+	}
+}
+
+inline void mul4x4x1(double *result, const double *left, const double *right)
+{
+	const __m256d row0 = _mm256_loadu_pd(left);
+	const __m256d row1 = _mm256_loadu_pd(left + 4u);
+	const __m256d row2 = _mm256_loadu_pd(left + 8u);
+	const __m256d row3 = _mm256_loadu_pd(left + 12u);
+
+	const __m256d low01		= _mm256_unpacklo_pd(row0, row1);
+	const __m256d high01	= _mm256_unpackhi_pd(row0, row1);
+	const __m256d low23		= _mm256_unpacklo_pd(row2, row3);
+	const __m256d high23	= _mm256_unpackhi_pd(row2, row3);
+
+	const __m256d column0 = _mm256_permute2f128_pd(low01, low23, 0x20);
+	const __m256d column1 = _mm256_permute2f128_pd(high01, high23, 0x20);
+	const __m256d column2 = _mm256_permute2f128_pd(low01, low23, 0x31);
+	const __m256d column3 = _mm256_permute2f128_pd(high01, high23, 0x31);
+
+	__m256d vector	= _mm256_mul_pd(column0, _mm256_broadcast_sd(right));
+	vector			= simd::multiplyAdd(column1, _mm256_broadcast_sd(right + 1u), vector);
+	vector			= simd::multiplyAdd(column2, _mm256_broadcast_sd(right + 2u), vector);
+	vector			= simd::multiplyAdd(column3, _mm256_broadcast_sd(right + 3u), vector);
+	_mm256_storeu_pd(result, vector);
+}
+
+inline void mul1x4x4(double *result, const double *left, const double *right)
+{
+	__m256d vector	= _mm256_mul_pd(_mm256_broadcast_sd(left), _mm256_loadu_pd(right));
+	vector			= simd::multiplyAdd(_mm256_broadcast_sd(left + 1u), _mm256_loadu_pd(right + 4u), vector);
+	vector			= simd::multiplyAdd(_mm256_broadcast_sd(left + 2u), _mm256_loadu_pd(right + 8u), vector);
+	vector			= simd::multiplyAdd(_mm256_broadcast_sd(left + 3u), _mm256_loadu_pd(right + 12u), vector);
+	_mm256_storeu_pd(result, vector);
+}
+#endif
+
+///
+/// Dispatches to the hand-vectorized kernel for the shape $L \times M \times N$. Only valid if \ref hasMul4Kernel holds.
+///
+template <std::size_t L, std::size_t M, std::size_t N, typename ValueType>
+inline void mul4(ValueType *result, const ValueType *left, const ValueType *right)
+{
+	static_assert(hasMul4Kernel<ValueType, L, M, N>);
+
+	if constexpr (N == 1u)
+	{
+		mul4x4x1(result, left, right);
+	}
+	else if constexpr (L == 1u)
+	{
+		mul1x4x4(result, left, right);
+	}
+	else
+	{
+		mul4x4x4(result, left, right);
+	}
+}
+
+} // namespace nd::math::detail
+
+#endif // ND_MATH_GEMM_HPP
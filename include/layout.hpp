@@ -0,0 +1,100 @@
+#ifndef ND_MATH_LAYOUT_HPP
+#define ND_MATH_LAYOUT_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+
+#include "simd.hpp"
+
+namespace nd::math::layout
+{
+
+///
+/// Memory layout policy storing each component of all vectors in one contiguous array, see \ref VectorSoA.
+///
+/// Like the layout policies of \c std::mdspan a policy is a tag whose nested \c Mapping computes where component \a order of vector
+/// \a index lives in an allocation of \a capacity vectors.
+///
+struct SoA
+{
+	template <typename ValueType, std::size_t Order>
+	struct Mapping
+	{
+		///
+		/// Whether every component is a single contiguous array.
+		///
+		static constexpr bool			contiguous	= true;
+
+		///
+		/// Capacities are rounded up to multiples of this many vectors: whole cache lines, so each component array starts aligned.
+		///
+		static constexpr std::size_t	granularity	= std::max<std::size_t>(simd::cacheLineSize / sizeof (ValueType), 1u);
+
+		///
+		/// Number of vectors processed per vector register by the batch kernels.
+		///
+		static constexpr std::size_t	lanes		= simd::width<ValueType>;
+
+		static constexpr std::size_t offset(const std::size_t order, const std::size_t index, const std::size_t capacity)
+		{
+			return order * capacity + index;
+		}
+
+		///
+		/// Returns the distance between two components of the same vector.
+		///
+		static constexpr std::size_t stride(const std::size_t capacity)
+		{
+			return capacity;
+		}
+
+		///
+		/// Returns the number of consecutive vectors whose components are contiguous; runs start at multiples of it.
+		///
+		static constexpr std::size_t run(const std::size_t capacity)
+		{
+			return capacity;
+		}
+	};
+};
+
+///
+/// Hybrid memory layout policy storing vectors in blocks of \a BlockSize, each holding one contiguous array per component.
+///
+/// All components of a vector lie within $Order \cdot BlockSize$ consecutive elements instead of $Order$ arrays apart, so accessing a single
+/// vector touches one or two cache lines while every component still fills whole vector registers. Blocks of 16 floats or 8 doubles
+/// occupy exactly one cache line per component.
+///
+template <std::size_t BlockSize>
+struct AoSoA
+{
+	static_assert(std::has_single_bit(BlockSize), "AoSoA blocks have to hold a power of two vectors");
+
+	template <typename ValueType, std::size_t Order>
+	struct Mapping
+	{
+		static constexpr bool			contiguous	= false;
+		static constexpr std::size_t	granularity	= BlockSize;
+		static constexpr std::size_t	lanes		= std::min(simd::width<ValueType>, BlockSize);
+
+		static constexpr std::size_t offset(const std::size_t order, const std::size_t index, const std::size_t)
+		{
+			return (index / BlockSize) * (Order * BlockSize) + order * BlockSize + (index % BlockSize);
+		}
+
+		static constexpr std::size_t stride(const std::size_t)
+		{
+			return BlockSize;
+		}
+
+		static constexpr std::size_t run(const std::size_t)
+		{
+			return BlockSize;
+		}
+	};
+};
+
+} // namespace nd::math::layout
+
+#endif // ND_MATH_LAYOUT_HPP
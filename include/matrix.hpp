@@ -12,10 +12,16 @@
 #include <ostream>
 #include <string>
 #include <type_traits>
+#include <utility>
 
 #include "common.hpp"
 #include "traits.hpp"
 #include "detail.hpp"
+#include "execution.hpp"
+#include "expression.hpp"
+#include "gemm.hpp"
+#include "threadpool.hpp"
+#include "transpose.hpp"
 
 namespace nd::math
 {
@@ -26,8 +32,8 @@ template <
 class MatrixRowView
 {
 public:
-	MatrixRowView(ValueType *data) :
-		_data(const_cast<ValueType *>(data))
+	constexpr MatrixRowView(ValueType *data) :
+		_data(data)
 	{
 	}
 
@@ -37,7 +43,7 @@ public:
 		return this->_data[index];
 	}
 
-	constexpr ValueType operator[](const std::size_t index) const
+	constexpr std::remove_const_t<ValueType> operator[](const std::size_t index) const
 	{
 		assert(index < Columns);
 		return this->_data[index];
@@ -50,7 +56,7 @@ public:
 
 	constexpr const ValueType *data() const
 	{
-		return const_cast<ValueType const * const>(this->_data);
+		return this->_data;
 	}
 
 private:
@@ -61,11 +67,20 @@ template <
 	typename ValueType,
 	std::size_t			Rows,
 	std::size_t			Columns>
-class Matrix
+class Matrix : public MatrixExpression<Matrix<ValueType, Rows, Columns>, ValueType, Rows, Columns>
 {
 public:
 	constexpr Matrix() = default;
 
+	///
+	/// Evaluates the element-wise \a expression in a single pass.
+	///
+	template <typename Expression>
+	constexpr Matrix(const MatrixExpression<Expression, ValueType, Rows, Columns> &expression)
+	{
+		this->assign(expression);
+	}
+
 	constexpr Matrix(const traits::initialization::Zero)
 	{
 		common::setZero(this->_data, Rows * Columns);
@@ -96,9 +111,11 @@ public:
 		common::copy(&this->_data[1u], vector.data(), Columns - 1u);
 	}
 
+	// The trailing parameter keeps this template distinct from the row vector one, both take a Matrix<ValueType, 1u, 1u> for 2x2 matrices
 	template <typename Unused_ = void,
 			  typename = traits::EnableVector<Rows, Columns, Unused_>,
-			  typename = traits::EnableNonZeroSizeVector<Rows - 1u, 1u, Unused_>>
+			  typename = traits::EnableNonZeroSizeVector<Rows - 1u, 1u, Unused_>,
+			  typename = void>
 	constexpr Matrix(const ValueType scalar, const Matrix<ValueType, Rows - 1u, 1u> &vector)
 	{
 		this->_data[0u] = scalar;
@@ -120,7 +137,20 @@ public:
 
 	constexpr const ValueType *data() const
 	{
-		return const_cast<ValueType const * const>(this->_data);
+		return this->_data;
+	}
+
+	///
+	/// Returns the distance between the first elements of two consecutive rows. Rows are packed tightly, see \ref PaddedMatrix for padded rows.
+	///
+	static constexpr std::size_t stride()
+	{
+		return Columns;
+	}
+
+	constexpr ValueType element(const std::size_t index) const
+	{
+		return this->_data[index];
 	}
 
 	constexpr void setZero()
@@ -128,10 +158,23 @@ public:
 		common::setZero(this->_data, Rows * Columns);
 	}
 
+	///
+	/// Returns the transposed matrix. Matrices with at least one register tile per dimension are transposed in cache-oblivious blocks of
+	/// register tiles, see \ref detail::transpose.
+	///
 	constexpr Matrix<ValueType, Columns, Rows> transposed() const
 	{
 		Matrix<ValueType, Columns, Rows> returnValue;
 
+		if constexpr ((Rows >= detail::transposeTile<ValueType>) & (Columns >= detail::transposeTile<ValueType>))
+		{
+			if (!std::is_constant_evaluated())
+			{
+				detail::transpose(this->data(), Columns, returnValue.data(), Rows, Rows, Columns);
+				return returnValue;
+			}
+		}
+
 		for (std::size_t i = 0u; i < Rows; ++i)
 		{
 			for (std::size_t j = 0u; j < Columns; ++j)
@@ -143,6 +186,32 @@ public:
 		return returnValue;
 	}
 
+	///
+	/// Transposes a square matrix in place, exchanging register tiles mirrored at the diagonal without a second matrix sized buffer.
+	///
+	template <typename Unused_ = void, typename = traits::EnableEqualSize<Rows, Columns, Unused_>>
+	constexpr Matrix &transpose()
+	{
+		if constexpr (Rows >= detail::transposeTile<ValueType>)
+		{
+			if (!std::is_constant_evaluated())
+			{
+				detail::transposeInPlace(this->_data, Columns, Rows);
+				return *this;
+			}
+		}
+
+		for (std::size_t i = 0u; i < Rows; ++i)
+		{
+			for (std::size_t j = i + 1u; j < Columns; ++j)
+			{
+				std::swap(this->_data[i * Columns + j], this->_data[j * Columns + i]);
+			}
+		}
+
+		return *this;
+	}
+
 	template <typename Unused_ = void, typename = traits::EnableVector<Rows, Columns, Unused_>>
 	constexpr ValueType squareNorm() const
 	{
@@ -166,7 +235,7 @@ public:
 	template <typename Unused_ = void, typename = traits::EnableVector<Rows, Columns, Unused_>>
 	constexpr Matrix &normalize()
 	{
-		*this *= this->norm();
+		*this /= this->norm();
 		return *this;
 	}
 
@@ -190,12 +259,58 @@ public:
 		return returnValue;
 	}
 
-	constexpr auto operator[](const std::size_t index) -> decltype (detail::subscript<ValueType, Rows, Columns>(nullptr, {}))
+	///
+	/// Returns the determinant of a square matrix, expanded into cofactors up to order four and computed from an LU factorization otherwise,
+	/// or from fraction-free elimination for integer elements, which keeps it exact.
+	///
+	template <typename Unused_ = void, typename = traits::EnableEqualSize<Rows, Columns, Unused_>>
+	constexpr ValueType determinant() const
+	{
+		return detail::determinant<Rows>(this->data());
+	}
+
+	///
+	/// Returns the inverse of a square matrix. Orders up to four use closed-form cofactor expansions, larger ones a partially pivoted LU
+	/// factorization. The elements of the result are not finite if the matrix is singular, and all NaN if the factorization finds a vanishing
+	/// pivot; check \ref determinant first where that can happen.
+	///
+	template <typename Unused_ = void, typename = traits::EnableEqualSize<Rows, Columns, Unused_>>
+	constexpr Matrix inverted() const
+	{
+		Matrix returnValue;
+		detail::inverse<Rows>(this->data(), returnValue._data);
+		return returnValue;
+	}
+
+	///
+	/// Returns $X$ solving $A X = B$ for this square matrix $A$ and the right-hand side \a rhs with one column per system, using a partially
+	/// pivoted LU factorization. Prefer this over multiplying by \ref inverted, which is both slower and less accurate. If a pivot vanishes
+	/// because the matrix is singular, every element of the result is NaN; check \ref determinant first where that can happen.
+	///
+	template <std::size_t RightColumns, typename Unused_ = void, typename = traits::EnableEqualSize<Rows, Columns, Unused_>>
+	constexpr Matrix<ValueType, Rows, RightColumns> solve(const Matrix<ValueType, Rows, RightColumns> &rhs) const
+	{
+		Matrix<ValueType, Rows, RightColumns>	returnValue;
+		Matrix									lu = *this;
+		std::size_t								permutation[Rows];
+
+		if (detail::luDecompose<Rows>(lu._data, permutation) == ValueType{})
+		{
+			std::fill_n(returnValue.data(), Rows * RightColumns, std::numeric_limits<ValueType>::quiet_NaN());
+			return returnValue;
+		}
+
+		detail::luSolve<Rows, RightColumns>(lu._data, permutation, rhs.data(), returnValue.data());
+
+		return returnValue;
+	}
+
+	constexpr detail::SubscriptType_v<ValueType, Rows, Columns> operator[](const std::size_t index)
 	{
 		return detail::subscript<ValueType, Rows, Columns>(this->_data, index);
 	}
 
-	constexpr auto operator[](const std::size_t index) const -> std::add_const_t<decltype (detail::subscript<ValueType, Rows, Columns>(nullptr, {}))>
+	constexpr detail::SubscriptType_v<const ValueType, Rows, Columns> operator[](const std::size_t index) const
 	{
 		return detail::subscript<ValueType, Rows, Columns>(this->_data, index);
 	}
@@ -210,27 +325,30 @@ public:
 		return !(*this == other);
 	}
 
-	constexpr Matrix &operator+=(const Matrix &other)
+	template <typename Expression>
+	constexpr Matrix &operator=(const MatrixExpression<Expression, ValueType, Rows, Columns> &expression)
 	{
-		for (std::size_t i = 0u; i < Rows; ++i)
+		this->assign(expression);
+		return *this;
+	}
+
+	template <typename Expression>
+	constexpr Matrix &operator+=(const MatrixExpression<Expression, ValueType, Rows, Columns> &expression)
+	{
+		for (std::size_t index = 0u; index < Rows * Columns; ++index)
 		{
-			for (std::size_t j = 0u; j < Columns; ++j)
-			{
-				detail::unifiedSubscript(*this, i, j) += detail::unifiedSubscript(other, i, j);
-			}
+			this->_data[index] += expression.element(index);
 		}
 
 		return *this;
 	}
 
-	constexpr Matrix &operator-=(const Matrix &other)
+	template <typename Expression>
+	constexpr Matrix &operator-=(const MatrixExpression<Expression, ValueType, Rows, Columns> &expression)
 	{
-		for (std::size_t i = 0u; i < Rows; ++i)
+		for (std::size_t index = 0u; index < Rows * Columns; ++index)
 		{
-			for (std::size_t j = 0u; j < Columns; ++j)
-			{
-				detail::unifiedSubscript(*this, i, j) -= detail::unifiedSubscript(other, i, j);
-			}
+			this->_data[index] -= expression.element(index);
 		}
 
 		return *this;
@@ -263,40 +381,6 @@ public:
 		return *this;
 	}
 
-	constexpr Matrix operator+(const Matrix &other) const
-	{
-		Matrix returnValue = *this;
-		returnValue += other;
-		return returnValue;
-	}
-
-	constexpr Matrix operator-(const Matrix &other) const
-	{
-		Matrix returnValue = *this;
-		returnValue -= other;
-		return returnValue;
-	}
-
-	constexpr Matrix operator*(const ValueType scalar) const
-	{
-		Matrix returnValue = *this;
-		returnValue *= scalar;
-		return returnValue;
-	}
-
-	constexpr Matrix operator/(const ValueType scalar) const
-	{
-		Matrix returnValue = *this;
-		returnValue /= scalar;
-		return returnValue;
-	}
-
-	template <typename Unused_ = void, typename = traits::EnableNegative<ValueType, Unused_>>
-	constexpr Matrix operator-() const
-	{
-		return (*this) * static_cast<ValueType>(-1);
-	}
-
 	template <typename Unused_ = void, typename = traits::EnableScalar<Rows, Columns, Unused_>>
 	constexpr operator ValueType() const
 	{
@@ -320,14 +404,19 @@ public:
 	}
 
 protected:
-	mutable ValueType _data[Rows * Columns];
-};
+	alignas (detail::storageAlignment<ValueType, Rows * Columns>) ValueType _data[Rows * Columns];
 
-template <typename ValueType, std::size_t Rows, std::size_t Columns>
-constexpr Matrix<ValueType, Rows, Columns> operator*(const ValueType scalar, const Matrix<ValueType, Rows, Columns> &matrix)
-{
-	return (matrix * scalar);
-}
+private:
+	template <typename Expression>
+	constexpr void assign(const MatrixExpression<Expression, ValueType, Rows, Columns> &expression)
+	{
+		// Element-wise expressions only read the element they write, so assigning an expression containing *this is safe
+		for (std::size_t index = 0u; index < Rows * Columns; ++index)
+		{
+			this->_data[index] = expression.element(index);
+		}
+	}
+};
 
 template <typename ValueType, std::size_t L, std::size_t M, std::size_t N>
 constexpr Matrix<ValueType, L, N> operator*(const Matrix<ValueType, L, M> &left, const Matrix<ValueType, M, N> &right)
@@ -339,9 +428,41 @@ constexpr Matrix<ValueType, L, N> operator*(const Matrix<ValueType, L, M> &left,
 	return returnValue;
 }
 
+///
+/// Matrix products are not element-wise, so expression operands are evaluated first.
+///
+template <typename Left, typename Right, typename ValueType, std::size_t L, std::size_t M, std::size_t N>
+constexpr Matrix<ValueType, L, N> operator*(const MatrixExpression<Left, ValueType, L, M> &left, const MatrixExpression<Right, ValueType, M, N> &right)
+{
+	return left.eval() * right.eval();
+}
+
 template <typename ValueType, std::size_t L, std::size_t M, std::size_t N>
 constexpr void mul(Matrix<ValueType, L, N> &result, const Matrix<ValueType, L, M> &left, const Matrix<ValueType, M, N> &right)
 {
+	using Blocking = detail::GemmBlocking<ValueType, L, M, N>;
+
+	if constexpr (detail::hasMul4Kernel<ValueType, L, M, N>)
+	{
+		if (!std::is_constant_evaluated())
+		{
+			detail::mul4<L, M, N>(result.data(), left.data(), right.data());
+			return;
+		}
+	}
+
+	if constexpr (Blocking::enabled)
+	{
+		if (!std::is_constant_evaluated())
+		{
+			detail::gemm<Blocking>(L, N, M, ValueType{1}, detail::GemmOperand<ValueType>{left.data(), M}, detail::GemmOperand<ValueType>{right.data(), N},
+								   ValueType{}, result.data(), N);
+			return;
+		}
+	}
+
+	// Reference implementation for tiny products and constant evaluation
+
 	result.setZero();
 
 	for (std::size_t i = 0u; i < L; ++i)
@@ -356,6 +477,126 @@ constexpr void mul(Matrix<ValueType, L, N> &result, const Matrix<ValueType, L, M
 	}
 }
 
+///
+/// Computes the product of \a left and \a right into \a result using the execution policy \a policy. With \ref execution::par large products
+/// are split into tiles that are distributed across \ref ThreadPool::instance; small products always run on the calling thread.
+///
+template <typename ExecutionPolicy, typename ValueType, std::size_t L, std::size_t M, std::size_t N,
+		  typename = std::enable_if_t<execution::isExecutionPolicy<ExecutionPolicy>>>
+void mul([[maybe_unused]] ExecutionPolicy &&policy, Matrix<ValueType, L, N> &result, const Matrix<ValueType, L, M> &left,
+		 const Matrix<ValueType, M, N> &right)
+{
+	using Blocking = detail::GemmBlocking<ValueType, L, M, N>;
+
+	if constexpr (execution::isParallelPolicy<ExecutionPolicy> & Blocking::parallel)
+	{
+		detail::gemmParallel<Blocking>(ThreadPool::instance(), L, N, M, ValueType{1}, detail::GemmOperand<ValueType>{left.data(), M},
+									   detail::GemmOperand<ValueType>{right.data(), N}, ValueType{}, result.data(), N);
+	}
+	else
+	{
+		mul(result, left, right);
+	}
+}
+
+///
+/// Returns the product of \a left and \a right computed using the execution policy \a policy.
+///
+template <typename ExecutionPolicy, typename ValueType, std::size_t L, std::size_t M, std::size_t N,
+		  typename = std::enable_if_t<execution::isExecutionPolicy<ExecutionPolicy>>>
+Matrix<ValueType, L, N> mul(ExecutionPolicy &&policy, const Matrix<ValueType, L, M> &left, const Matrix<ValueType, M, N> &right)
+{
+	Matrix<ValueType, L, N> returnValue;
+
+	mul(std::forward<ExecutionPolicy>(policy), returnValue, left, right);
+
+	return returnValue;
+}
+
+///
+/// Selects whether \ref gemm reads an operand as stored or as its transpose.
+///
+enum class Transposition
+{
+	none,
+	transpose
+};
+
+namespace detail
+{
+
+template <Transposition Operation, std::size_t Rows, std::size_t Columns>
+inline constexpr std::size_t operationRows = (Operation == Transposition::none) ? Rows : Columns;
+
+template <Transposition Operation, std::size_t Rows, std::size_t Columns>
+inline constexpr std::size_t operationColumns = (Operation == Transposition::none) ? Columns : Rows;
+
+} // namespace detail
+
+///
+/// Computes $C \leftarrow \alpha\,op(A)\,op(B) + \beta C$ into \a result in a single pass, where $op$ either is the identity or transposes its
+/// operand as selected by \a LeftTransposition and \a RightTransposition. Transposed operands are read in place, and a \a beta of zero never
+/// reads \a result, so updates like $C \mathrel{+}= A B^T$ need neither temporaries nor an extra pass. \a result must not alias an operand.
+///
+template <Transposition LeftTransposition = Transposition::none, Transposition RightTransposition = Transposition::none,
+		  typename ValueType, std::size_t LeftRows, std::size_t LeftColumns, std::size_t RightRows, std::size_t RightColumns, std::size_t L,
+		  std::size_t N>
+constexpr void gemm(const std::type_identity_t<ValueType> alpha, const Matrix<ValueType, LeftRows, LeftColumns> &left,
+					const Matrix<ValueType, RightRows, RightColumns> &right, const std::type_identity_t<ValueType> beta, Matrix<ValueType, L, N> &result)
+{
+	constexpr std::size_t M = detail::operationColumns<LeftTransposition, LeftRows, LeftColumns>;
+
+	static_assert((detail::operationRows<LeftTransposition, LeftRows, LeftColumns> == L) &
+				  (detail::operationRows<RightTransposition, RightRows, RightColumns> == M) &
+				  (detail::operationColumns<RightTransposition, RightRows, RightColumns> == N), "Operand dimensions do not match");
+
+	using Blocking = detail::GemmBlocking<ValueType, L, M, N>;
+
+	const auto leftOperand	= detail::GemmOperand<ValueType>::make(left.data(), LeftColumns, LeftTransposition == Transposition::transpose);
+	const auto rightOperand	= detail::GemmOperand<ValueType>::make(right.data(), RightColumns, RightTransposition == Transposition::transpose);
+
+	if constexpr (Blocking::enabled)
+	{
+		if (!std::is_constant_evaluated())
+		{
+			detail::gemm<Blocking>(L, N, M, alpha, leftOperand, rightOperand, beta, result.data(), N);
+			return;
+		}
+	}
+
+	detail::gemmReference(L, N, M, alpha, leftOperand, rightOperand, beta, result.data(), N);
+}
+
+///
+/// Computes $C \leftarrow \alpha\,op(A)\,op(B) + \beta C$ using the execution policy \a policy, see \ref gemm.
+///
+template <Transposition LeftTransposition = Transposition::none, Transposition RightTransposition = Transposition::none,
+		  typename ExecutionPolicy, typename ValueType, std::size_t LeftRows, std::size_t LeftColumns, std::size_t RightRows,
+		  std::size_t RightColumns, std::size_t L, std::size_t N, typename = std::enable_if_t<execution::isExecutionPolicy<ExecutionPolicy>>>
+void gemm([[maybe_unused]] ExecutionPolicy &&policy, const std::type_identity_t<ValueType> alpha, const Matrix<ValueType, LeftRows, LeftColumns> &left,
+		  const Matrix<ValueType, RightRows, RightColumns> &right, const std::type_identity_t<ValueType> beta, Matrix<ValueType, L, N> &result)
+{
+	constexpr std::size_t M = detail::operationColumns<LeftTransposition, LeftRows, LeftColumns>;
+
+	using Blocking = detail::GemmBlocking<ValueType, L, M, N>;
+
+	if constexpr (execution::isParallelPolicy<ExecutionPolicy> & Blocking::parallel)
+	{
+		static_assert((detail::operationRows<LeftTransposition, LeftRows, LeftColumns> == L) &
+					  (detail::operationRows<RightTransposition, RightRows, RightColumns> == M) &
+					  (detail::operationColumns<RightTransposition, RightRows, RightColumns> == N), "Operand dimensions do not match");
+
+		detail::gemmParallel<Blocking>(ThreadPool::instance(), L, N, M, alpha,
+									   detail::GemmOperand<ValueType>::make(left.data(), LeftColumns, LeftTransposition == Transposition::transpose),
+									   detail::GemmOperand<ValueType>::make(right.data(), RightColumns, RightTransposition == Transposition::transpose),
+									   beta, result.data(), N);
+	}
+	else
+	{
+		gemm<LeftTransposition, RightTransposition>(alpha, left, right, beta, result);
+	}
+}
+
 template <typename ValueType, std::size_t Rows, std::size_t Columns>
 std::ostream &operator<<(std::ostream &stream, const Matrix<ValueType, Rows, Columns> &matrix)
 {
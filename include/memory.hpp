@@ -0,0 +1,144 @@
+#ifndef ND_MATH_MEMORY_HPP
+#define ND_MATH_MEMORY_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "simd.hpp"
+
+namespace nd::math::memory
+{
+
+///
+/// Owning, move-only buffer of \a ValueType elements aligned to \a Alignment bytes.
+///
+/// The elements are left uninitialized, which is why \a ValueType has to be trivially copyable.
+///
+template <typename ValueType, std::size_t Alignment = simd::cacheLineSize>
+class AlignedBuffer
+{
+	static_assert(std::is_trivially_copyable_v<ValueType>, "AlignedBuffer requires trivially copyable elements");
+	static_assert((Alignment & (Alignment - 1u)) == 0u, "Alignment has to be a power of two");
+
+public:
+	static constexpr std::size_t alignment = Alignment;
+
+	AlignedBuffer() = default;
+
+	explicit AlignedBuffer(const std::size_t size) :
+		_data(AlignedBuffer::allocate(size)),
+		_size(size)
+	{
+	}
+
+	AlignedBuffer(const AlignedBuffer &other) = delete;
+
+	AlignedBuffer(AlignedBuffer &&other) noexcept :
+		_data(std::exchange(other._data, nullptr)),
+		_size(std::exchange(other._size, 0u))
+	{
+	}
+
+	~AlignedBuffer()
+	{
+		AlignedBuffer::deallocate(this->_data);
+	}
+
+	AlignedBuffer &operator=(const AlignedBuffer &other) = delete;
+
+	AlignedBuffer &operator=(AlignedBuffer &&other) noexcept
+	{
+		if (this != &other)
+		{
+			AlignedBuffer::deallocate(this->_data);
+			this->_data = std::exchange(other._data, nullptr);
+			this->_size = std::exchange(other._size, 0u);
+		}
+
+		return *this;
+	}
+
+	ValueType *data()
+	{
+		return this->_data;
+	}
+
+	const ValueType *data() const
+	{
+		return this->_data;
+	}
+
+	std::size_t size() const
+	{
+		return this->_size;
+	}
+
+	///
+	/// Makes room for at least \a size elements. Growing the buffer discards its contents.
+	///
+	void reserve(const std::size_t size)
+	{
+		if (size > this->_size)
+		{
+			AlignedBuffer::deallocate(this->_data);
+			this->_data = nullptr;
+			this->_size = 0u;
+
+			this->_data = AlignedBuffer::allocate(size);
+			this->_size = size;
+		}
+	}
+
+	ValueType &operator[](const std::size_t index)
+	{
+		assert(index < this->_size);
+		return this->_data[index];
+	}
+
+	const ValueType &operator[](const std::size_t index) const
+	{
+		assert(index < this->_size);
+		return this->_data[index];
+	}
+
+private:
+	ValueType	*_data	= nullptr;
+	std::size_t	_size	= 0u;
+
+	static ValueType *allocate(const std::size_t size)
+	{
+		if (size == 0u)
+		{
+			return nullptr;
+		}
+
+		return static_cast<ValueType *>(::operator new(size * sizeof (ValueType), std::align_val_t{Alignment}));
+	}
+
+	static void deallocate(ValueType *data)
+	{
+		if (data != nullptr)
+		{
+			::operator delete(data, std::align_val_t{Alignment});
+		}
+	}
+};
+
+///
+/// Returns a thread local scratch buffer that holds at least \a size elements. Buffers are reused across calls so hot kernels do not allocate
+/// once warmed up. Distinct \a Slot values yield distinct buffers.
+///
+template <typename ValueType, std::size_t Slot>
+inline ValueType *scratch(const std::size_t size)
+{
+	thread_local AlignedBuffer<ValueType> buffer;
+	buffer.reserve(size);
+	return buffer.data();
+}
+
+} // namespace nd::math::memory
+
+#endif // ND_MATH_MEMORY_HPP
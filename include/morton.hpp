@@ -0,0 +1,382 @@
+#ifndef ND_MATH_MORTON_HPP
+#define ND_MATH_MORTON_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "boundingbox.hpp"
+#include "threadpool.hpp"
+#include "vectorsoa.hpp"
+
+namespace nd::math
+{
+
+namespace detail
+{
+
+///
+/// Number of bits per component of \a Order dimensional Morton codes of type \a Code: 10 and 21 for three dimensional 32 and 64 bit codes.
+///
+template <typename Code, std::size_t Order>
+inline constexpr std::size_t mortonBits = std::numeric_limits<Code>::digits / Order;
+
+///
+/// Default number of elements per chunk of \ref radixSort.
+///
+inline constexpr std::size_t radixSortGrainSize = 65536u;
+
+///
+/// Spreads the low \ref mortonBits bits of every lane of \a value, so bit $b$ moves to bit $b \cdot Order$.
+///
+/// Two and three dimensional codes interleave in $\log_2$ of the bit count steps of shifts and masks, which work on vector registers of
+/// codes as well; other orders move one bit at a time. Registers of codes may be wider than the native ones, so they are passed by reference.
+///
+template <typename Code, std::size_t Order, typename Lane>
+inline void mortonSpread(Lane &value)
+{
+	constexpr std::size_t bits = mortonBits<Code, Order>;
+
+	value &= Code((Code{1u} << bits) - 1u);
+
+	if constexpr ((Order == 3u) & (bits == 10u))
+	{
+		value = (value | (value << 16u)) & Code(0x030000FFu);
+		value = (value | (value << 8u)) & Code(0x0300F00Fu);
+		value = (value | (value << 4u)) & Code(0x030C30C3u);
+		value = (value | (value << 2u)) & Code(0x09249249u);
+	}
+	else if constexpr ((Order == 3u) & (bits == 21u))
+	{
+		value = (value | (value << 32u)) & Code(0x001F00000000FFFFu);
+		value = (value | (value << 16u)) & Code(0x001F0000FF0000FFu);
+		value = (value | (value << 8u)) & Code(0x100F00F00F00F00Fu);
+		value = (value | (value << 4u)) & Code(0x10C30C30C30C30C3u);
+		value = (value | (value << 2u)) & Code(0x1249249249249249u);
+	}
+	else if constexpr ((Order == 2u) & (bits == 16u))
+	{
+		value = (value | (value << 8u)) & Code(0x00FF00FFu);
+		value = (value | (value << 4u)) & Code(0x0F0F0F0Fu);
+		value = (value | (value << 2u)) & Code(0x33333333u);
+		value = (value | (value << 1u)) & Code(0x55555555u);
+	}
+	else if constexpr ((Order == 2u) & (bits == 32u))
+	{
+		value = (value | (value << 16u)) & Code(0x0000FFFF0000FFFFu);
+		value = (value | (value << 8u)) & Code(0x00FF00FF00FF00FFu);
+		value = (value | (value << 4u)) & Code(0x0F0F0F0F0F0F0F0Fu);
+		value = (value | (value << 2u)) & Code(0x3333333333333333u);
+		value = (value | (value << 1u)) & Code(0x5555555555555555u);
+	}
+	else
+	{
+		Lane spread = value & Code{1u};
+
+		for (std::size_t bit = 1u; bit < bits; ++bit)
+		{
+			spread |= ((value >> bit) & Code{1u}) << (bit * Order);
+		}
+
+		value = spread;
+	}
+}
+
+template <typename Code, typename ValueType, typename Lane>
+inline constexpr auto mortonLane()
+{
+	if constexpr (std::is_same_v<Lane, ValueType>)
+	{
+		return std::type_identity<Code>{};
+	}
+#if defined(__GNUC__)
+	else
+	{
+		return std::type_identity<BatchRegister<Code, sizeof (Lane) / sizeof (ValueType)>>{};
+	}
+#endif
+}
+
+///
+/// Lane of codes matching the lane \a Lane of \a ValueType components, a single code or a register of as many codes.
+///
+template <typename Code, typename ValueType, typename Lane>
+using MortonLane = typename decltype(mortonLane<Code, ValueType, Lane>())::type;
+
+///
+/// Converts every lane of \a value to a code in \a result.
+///
+template <typename Lane, typename CodeLane>
+inline void mortonQuantize(const Lane &value, CodeLane &result)
+{
+	if constexpr (std::is_arithmetic_v<Lane>)
+	{
+		result = static_cast<CodeLane>(value);
+	}
+#if defined(__GNUC__)
+	else
+	{
+		result = __builtin_convertvector(value, CodeLane);
+	}
+#endif
+}
+
+} // namespace detail
+
+///
+/// Writes the Morton codes of \a points to \a codes: the components are quantized to \ref detail::mortonBits bits across \a bounds and their
+/// bits interleaved, component zero in the lowest bit. Sorting points by their codes orders them along a Z-order curve, so points close in
+/// space mostly end up close in memory.
+///
+/// Three dimensional points yield 30 bit codes as \c std::uint32_t and 63 bit codes as \c std::uint64_t. Components outside of \a bounds are
+/// clamped to it, NaN components give unspecified codes.
+///
+template <typename Code, typename ValueType, std::size_t Order, typename Layout>
+void mortonCodes(const VectorSoAView<ValueType, Order, Layout> points, const BoundingBox<std::remove_const_t<ValueType>, Order> &bounds,
+				 const std::span<Code> codes)
+{
+	using Element	= std::remove_const_t<ValueType>;
+	using Mapping	= typename VectorSoAView<ValueType, Order, Layout>::Mapping;
+
+	static_assert(std::is_unsigned_v<Code> & std::is_floating_point_v<Element>, "Morton codes map floating point vectors to unsigned codes");
+	static_assert(Order >= 2u, "Morton codes interleave at least two components");
+	assert(points.size() == codes.size());
+
+	constexpr Code		largestCode	= (Code{1u} << detail::mortonBits<Code, Order>) - 1u;
+	constexpr Element	largest		= static_cast<Element>(largestCode);
+
+	// Degenerate extents map to code zero instead of dividing by zero
+	Element minimum[Order];
+	Element scale[Order];
+
+	for (std::size_t order = 0u; order < Order; ++order)
+	{
+		const Element extent = bounds.maximum[order] - bounds.minimum[order];
+
+		minimum[order]	= bounds.minimum[order];
+		scale[order]	= (extent > Element{}) ? (largest / extent) : Element{};
+	}
+
+	const std::size_t head = detail::batchHead<Mapping>(points.size(), points.offset());
+
+	detail::batch<Element, Mapping::lanes>(head, points.size(), [points, codes, &minimum, &scale](const std::size_t index, auto lane)
+	{
+		using Lane = decltype(lane);
+
+		using CodeLane = detail::MortonLane<Code, Element, Lane>;
+
+		CodeLane code = {};
+
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			Lane value = (detail::batchLoad<Lane>(points.data(order, index)) - minimum[order]) * scale[order];
+
+			value = (value > Element{}) ? value : Lane{} + Element{};
+			value = (value < largest) ? value : Lane{} + largest;
+
+			// The largest code may round up when converted to floating point
+			CodeLane quantized;
+			detail::mortonQuantize(value, quantized);
+
+			quantized = (quantized < largestCode) ? quantized : CodeLane{} + largestCode;
+
+			detail::mortonSpread<Code, Order>(quantized);
+			code |= quantized << order;
+		}
+
+		detail::batchStore(codes.data() + index, code);
+	});
+}
+
+template <typename Code, typename ValueType, std::size_t Order, typename Layout>
+void mortonCodes(const VectorSoA<ValueType, Order, Layout> &points, const std::span<Code> codes)
+{
+	mortonCodes(points.view(), parallelStatistics(points).bounds, codes);
+}
+
+///
+/// Sorts \a keys in ascending order and applies the same permutation to \a values, keeping the order of equal keys.
+///
+/// This is a least significant digit radix sort on bytes. Every pass counts the digits of chunks of \a grainSize keys in parallel, derives
+/// the destination of every chunk and digit from the counts and scatters the chunks in parallel. Passes over bytes all keys share are
+/// skipped, so codes of few bits only take as many passes as they have bytes.
+///
+template <typename Key, typename Value>
+void radixSort(const std::span<Key> keys, const std::span<Value> values, const std::size_t grainSize = detail::radixSortGrainSize)
+{
+	static_assert(std::is_unsigned_v<Key>, "Radix sort requires unsigned keys");
+	assert(keys.size() == values.size());
+
+	constexpr std::size_t radix = 256u;
+
+	const std::size_t size			= keys.size();
+	const std::size_t chunkSize		= std::max<std::size_t>(grainSize, 1u);
+	const std::size_t chunkCount	= (size + chunkSize - 1u) / chunkSize;
+
+	std::vector<Key>			keyBuffer(size);
+	std::vector<Value>			valueBuffer(size);
+	std::vector<std::size_t>	offsets(chunkCount * radix);
+
+	Key		*sourceKeys				= keys.data();
+	Value	*sourceValues			= values.data();
+	Key		*destinationKeys		= keyBuffer.data();
+	Value	*destinationValues		= valueBuffer.data();
+
+	for (std::size_t shift = 0u; shift < std::numeric_limits<Key>::digits; shift += 8u)
+	{
+		ThreadPool::instance().parallelFor(chunkCount, [&, shift](const std::size_t chunk)
+		{
+			std::size_t * const counts = offsets.data() + chunk * radix;
+
+			std::fill_n(counts, radix, std::size_t{0u});
+
+			for (std::size_t index = chunk * chunkSize; index < std::min(size, (chunk + 1u) * chunkSize); ++index)
+			{
+				++counts[(sourceKeys[index] >> shift) & (radix - 1u)];
+			}
+		});
+
+		// Turn the counts into destinations, digit by digit and chunk by chunk within each digit, which keeps the sort stable
+		std::size_t total		= 0u;
+		bool		constant	= false;
+
+		for (std::size_t digit = 0u; digit < radix; ++digit)
+		{
+			const std::size_t first = total;
+
+			for (std::size_t chunk = 0u; chunk < chunkCount; ++chunk)
+			{
+				const std::size_t count = offsets[chunk * radix + digit];
+
+				offsets[chunk * radix + digit]	= total;
+				total							+= count;
+			}
+
+			constant |= (total - first) == size;
+		}
+
+		if (constant)
+		{
+			continue;
+		}
+
+		ThreadPool::instance().parallelFor(chunkCount, [&, shift](const std::size_t chunk)
+		{
+			std::size_t * const destinations = offsets.data() + chunk * radix;
+
+			for (std::size_t index = chunk * chunkSize; index < std::min(size, (chunk + 1u) * chunkSize); ++index)
+			{
+				const std::size_t destination = destinations[(sourceKeys[index] >> shift) & (radix - 1u)]++;
+
+				destinationKeys[destination]	= sourceKeys[index];
+				destinationValues[destination]	= std::move(sourceValues[index]);
+			}
+		});
+
+		std::swap(sourceKeys, destinationKeys);
+		std::swap(sourceValues, destinationValues);
+	}
+
+	if (sourceKeys != keys.data())
+	{
+		std::copy_n(sourceKeys, size, keys.data());
+		std::move(sourceValues, sourceValues + size, values.data());
+	}
+}
+
+///
+/// Reorders \a vectors so vector $i$ becomes the vector at index \a permutation[i] before, gathering into a new allocation in parallel.
+///
+template <typename ValueType, std::size_t Order, typename Layout>
+void permute(VectorSoA<ValueType, Order, Layout> &vectors, const std::span<const std::uint32_t> permutation)
+{
+	assert(permutation.size() == vectors.size());
+
+	VectorSoA<ValueType, Order, Layout> result{vectors.size()};
+
+	parallelForEach(result.view(), [&vectors, permutation](const VectorSoAView<ValueType, Order, Layout> chunk)
+	{
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			for (std::size_t index = 0u; index < chunk.size(); ++index)
+			{
+				*chunk.data(order, index) = *vectors.data(order, permutation[chunk.offset() + index]);
+			}
+		}
+	});
+
+	vectors = std::move(result);
+}
+
+///
+/// Reorders the random access \a range of attributes like the vectors of \ref permute.
+///
+template <typename Range>
+void permute(Range &range, const std::span<const std::uint32_t> permutation)
+{
+	using Value = std::ranges::range_value_t<Range>;
+
+	static_assert(std::ranges::random_access_range<Range>, "Only random access ranges can be permuted");
+	assert(permutation.size() == std::size_t(std::ranges::size(range)));
+
+	const auto				source = std::ranges::begin(range);
+	std::vector<Value>		result(permutation.size());
+
+	ThreadPool::instance().parallelFor((result.size() + detail::parallelGrainSize - 1u) / detail::parallelGrainSize, [&](const std::size_t chunk)
+	{
+		const std::size_t end = std::min(result.size(), (chunk + 1u) * detail::parallelGrainSize);
+
+		for (std::size_t index = chunk * detail::parallelGrainSize; index < end; ++index)
+		{
+			result[index] = std::move(source[permutation[index]]);
+		}
+	});
+
+	std::ranges::move(result, source);
+}
+
+///
+/// Returns the permutation sorting \a points by their Morton codes of type \a Code, see \ref mortonCodes, without reordering them.
+///
+template <typename Code = std::uint32_t, typename ValueType, std::size_t Order, typename Layout>
+std::vector<std::uint32_t> mortonOrder(const VectorSoA<ValueType, Order, Layout> &points)
+{
+	assert(points.size() <= std::numeric_limits<std::uint32_t>::max());
+
+	std::vector<Code>			codes(points.size());
+	std::vector<std::uint32_t>	returnValue(points.size());
+
+	mortonCodes(points, std::span<Code>{codes});
+	std::iota(returnValue.begin(), returnValue.end(), std::uint32_t{0u});
+	radixSort(std::span<Code>{codes}, std::span<std::uint32_t>{returnValue});
+
+	return returnValue;
+}
+
+///
+/// Reorders \a points and the attribute ranges or containers \a attributes, which have as many elements, into Z-order and returns the
+/// permutation, which reorders further attributes the same way with \ref permute.
+///
+template <typename Code = std::uint32_t, typename ValueType, std::size_t Order, typename Layout, typename... Attributes>
+std::vector<std::uint32_t> mortonSort(VectorSoA<ValueType, Order, Layout> &points, Attributes &...attributes)
+{
+	std::vector<std::uint32_t> returnValue = mortonOrder<Code>(points);
+
+	permute(points, returnValue);
+	(permute(attributes, returnValue), ...);
+
+	return returnValue;
+}
+
+} // namespace nd::math
+
+#endif // ND_MATH_MORTON_HPP
@@ -0,0 +1,497 @@
+#ifndef ND_MATH_PADDED_MATRIX_HPP
+#define ND_MATH_PADDED_MATRIX_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <type_traits>
+
+#include "common.hpp"
+#include "dynamicmatrix.hpp"
+#include "expression.hpp"
+#include "gemm.hpp"
+#include "matrix.hpp"
+#include "simd.hpp"
+#include "traits.hpp"
+
+namespace nd::math
+{
+
+template <
+	typename ValueType,
+	std::size_t			Rows,
+	std::size_t			Columns>
+class PaddedMatrix;
+
+namespace detail
+{
+
+///
+/// Distance between two rows of a \ref PaddedMatrix: short rows are widened to the next power of two so they fill a whole SSE or AVX lane
+/// set, longer rows to a multiple of the register width. Column vectors stay packed since padding them would multiply their size.
+///
+template <typename ValueType, std::size_t Columns>
+inline constexpr std::size_t paddedStride = (Columns == 1u) ? 1u
+																: ((Columns <= simd::width<ValueType>) ? std::bit_ceil(Columns)
+																									   : roundUp(Columns, simd::width<ValueType>));
+
+template <typename ValueType, std::size_t Rows, std::size_t Columns>
+struct IsMatrix<PaddedMatrix<ValueType, Rows, Columns>> : std::true_type {};
+
+#if defined(ND_MATH_VECTOR_SHUFFLE)
+template <typename ValueType>
+using QuadRegister __attribute__ ((vector_size (4u * sizeof (ValueType)))) = ValueType;
+#endif
+
+} // namespace detail
+
+///
+/// Fixed size matrix whose storage is aligned for vector loads and whose rows are padded to \ref stride elements.
+///
+/// A \ref Matrix is packed tightly, so a row of three floats straddles two vector lanes and none of its loads is guaranteed to be aligned.
+/// PaddedMatrix trades memory for full-width access: a \c PaddedVector3_f occupies one aligned 16 byte lane and \c PaddedMatrix3x3_f stores
+/// its rows 16 bytes apart. The padding elements are always zero, so kernels may read, add and multiply whole rows without masking. Elements
+/// are indexed logically, row-major, exactly like the elements of \ref Matrix, which both types convert to and from.
+///
+template <
+	typename ValueType,
+	std::size_t			Rows,
+	std::size_t			Columns>
+class PaddedMatrix : public MatrixExpression<PaddedMatrix<ValueType, Rows, Columns>, ValueType, Rows, Columns>
+{
+public:
+	static constexpr bool isVector = ((Rows == 1u) | (Columns == 1u));
+
+#if defined(ND_MATH_VECTOR_SHUFFLE)
+	///
+	/// Whether the whole storage fits into a single register, which the 3D and 4D vector operations then operate on directly.
+	///
+	static constexpr bool isQuad = ((Rows * detail::paddedStride<ValueType, Columns>) == 4u) & ((4u * sizeof (ValueType)) <= simd::registerSize);
+#endif
+
+	///
+	/// Zero initializes all elements, including the padding.
+	///
+	constexpr PaddedMatrix() = default;
+
+	///
+	/// Evaluates the element-wise \a expression, which may be a \ref Matrix, in a single pass.
+	///
+	template <typename Expression>
+	constexpr explicit PaddedMatrix(const MatrixExpression<Expression, ValueType, Rows, Columns> &expression)
+	{
+		this->assign(expression);
+	}
+
+	constexpr PaddedMatrix(const traits::initialization::Zero)
+	{
+	}
+
+	template <typename Unused_ = void, typename = traits::EnableEqualSize<Rows, Columns, Unused_>>
+	constexpr PaddedMatrix(const traits::initialization::Identity)
+	{
+		for (std::size_t order = 0u; order < Rows; ++order)
+		{
+			this->_data[order * PaddedMatrix::stride() + order] = static_cast<ValueType>(1);
+		}
+	}
+
+	constexpr PaddedMatrix(const std::array<ValueType, Rows * Columns> &values)
+	{
+		for (std::size_t rowIndex = 0u; rowIndex < Rows; ++rowIndex)
+		{
+			common::copy(this->rowData(rowIndex), &values[rowIndex * Columns], Columns);
+		}
+	}
+
+	constexpr ValueType *data()
+	{
+		return this->_data;
+	}
+
+	constexpr const ValueType *data() const
+	{
+		return this->_data;
+	}
+
+	///
+	/// Returns the distance between the first elements of two consecutive rows. Every row starts on a multiple of the storage alignment
+	/// whenever the stride spans a whole vector register.
+	///
+	static constexpr std::size_t stride()
+	{
+		return detail::paddedStride<ValueType, Columns>;
+	}
+
+	///
+	/// Returns the number of stored elements, including the padding.
+	///
+	static constexpr std::size_t storageSize()
+	{
+		return Rows * PaddedMatrix::stride();
+	}
+
+	constexpr ValueType element(const std::size_t index) const
+	{
+		return this->_data[(index / Columns) * PaddedMatrix::stride() + (index % Columns)];
+	}
+
+	constexpr void setZero()
+	{
+		common::setZero(this->_data, PaddedMatrix::storageSize());
+	}
+
+	constexpr PaddedMatrix<ValueType, Columns, Rows> transposed() const
+	{
+		PaddedMatrix<ValueType, Columns, Rows> returnValue;
+
+		for (std::size_t i = 0u; i < Rows; ++i)
+		{
+			for (std::size_t j = 0u; j < Columns; ++j)
+			{
+				returnValue.data()[j * returnValue.stride() + i] = this->_data[i * PaddedMatrix::stride() + j];
+			}
+		}
+
+		return returnValue;
+	}
+
+	///
+	/// Returns the dot product of two vectors. The zero padding does not contribute, so the whole storage is reduced at once.
+	///
+	template <typename Unused_ = void, typename = traits::EnableVector<Rows, Columns, Unused_>>
+	constexpr ValueType dot(const PaddedMatrix &other) const
+	{
+#if defined(ND_MATH_VECTOR_SHUFFLE)
+		if constexpr (PaddedMatrix::isQuad)
+		{
+			if (!std::is_constant_evaluated())
+			{
+				const detail::QuadRegister<ValueType> product = this->quad() * other.quad();
+				return (product[0u] + product[1u]) + (product[2u] + product[3u]);
+			}
+		}
+#endif
+
+		ValueType returnValue = {};
+
+		for (std::size_t index = 0u; index < PaddedMatrix::storageSize(); ++index)
+		{
+			returnValue += this->_data[index] * other._data[index];
+		}
+
+		return returnValue;
+	}
+
+	template <typename Unused_ = void, typename = traits::EnableVector<Rows, Columns, Unused_>>
+	constexpr ValueType squareNorm() const
+	{
+		return this->dot(*this);
+	}
+
+	template <typename Unused_ = void, typename = traits::EnableVector<Rows, Columns, Unused_>>
+	constexpr ValueType norm() const
+	{
+		using std::sqrt;
+		return sqrt(this->squareNorm());
+	}
+
+	template <typename Unused_ = void, typename = traits::EnableVector<Rows, Columns, Unused_>>
+	constexpr PaddedMatrix &normalize()
+	{
+		*this /= this->norm();
+		return *this;
+	}
+
+	template <typename Unused_ = void, typename = traits::EnableVector<Rows, Columns, Unused_>>
+	constexpr PaddedMatrix normalized() const
+	{
+		PaddedMatrix returnValue = *this;
+		returnValue.normalize();
+		return returnValue;
+	}
+
+	///
+	/// Returns the cross product of two 3D vectors. Padded row vectors are computed in one register with three shuffles as
+	/// $(a b_{yzx} - a_{yzx} b)_{yzx}$, the padding lane evaluates to zero.
+	///
+	template <typename Unused_ = void, typename = traits::Enable3DVector<Rows, Columns, Unused_>>
+	constexpr PaddedMatrix cross(const PaddedMatrix &other) const
+	{
+		PaddedMatrix returnValue;
+
+#if defined(ND_MATH_VECTOR_SHUFFLE)
+		if constexpr (PaddedMatrix::isQuad)
+		{
+			if (!std::is_constant_evaluated())
+			{
+				const detail::QuadRegister<ValueType> left	= this->quad();
+				const detail::QuadRegister<ValueType> right	= other.quad();
+
+				const detail::QuadRegister<ValueType> rotated	= left * __builtin_shufflevector(right, right, 1, 2, 0, 3) -
+																  __builtin_shufflevector(left, left, 1, 2, 0, 3) * right;
+				const detail::QuadRegister<ValueType> product	= __builtin_shufflevector(rotated, rotated, 1, 2, 0, 3);
+
+				std::memcpy(returnValue._data, &product, sizeof (product));
+				return returnValue;
+			}
+		}
+#endif
+
+		returnValue[0u] = (*this)[1u] * other[2u] - (*this)[2u] * other[1u];
+		returnValue[1u] = (*this)[2u] * other[0u] - (*this)[0u] * other[2u];
+		returnValue[2u] = (*this)[0u] * other[1u] - (*this)[1u] * other[0u];
+
+		return returnValue;
+	}
+
+	///
+	/// Returns row \a index of a matrix, or element \a index of a vector.
+	///
+	constexpr decltype (auto) operator[](const std::size_t index)
+	{
+		if constexpr (PaddedMatrix::isVector)
+		{
+			assert(index < Rows * Columns);
+			return (this->_data[index]);
+		}
+		else
+		{
+			assert(index < Rows);
+			return MatrixRowView<ValueType, Columns>{this->rowData(index)};
+		}
+	}
+
+	constexpr decltype (auto) operator[](const std::size_t index) const
+	{
+		if constexpr (PaddedMatrix::isVector)
+		{
+			assert(index < Rows * Columns);
+			return this->_data[index];
+		}
+		else
+		{
+			assert(index < Rows);
+			return MatrixRowView<const ValueType, Columns>{this->rowData(index)};
+		}
+	}
+
+	constexpr bool operator==(const PaddedMatrix &other) const
+	{
+		return common::isEqual(this->_data, other._data, PaddedMatrix::storageSize());
+	}
+
+	constexpr bool operator!=(const PaddedMatrix &other) const
+	{
+		return !(*this == other);
+	}
+
+	template <typename Expression>
+	constexpr PaddedMatrix &operator=(const MatrixExpression<Expression, ValueType, Rows, Columns> &expression)
+	{
+		this->assign(expression);
+		return *this;
+	}
+
+	constexpr PaddedMatrix &operator+=(const PaddedMatrix &other)
+	{
+		for (std::size_t index = 0u; index < PaddedMatrix::storageSize(); ++index)
+		{
+			this->_data[index] += other._data[index];
+		}
+
+		return *this;
+	}
+
+	constexpr PaddedMatrix &operator-=(const PaddedMatrix &other)
+	{
+		for (std::size_t index = 0u; index < PaddedMatrix::storageSize(); ++index)
+		{
+			this->_data[index] -= other._data[index];
+		}
+
+		return *this;
+	}
+
+	template <typename Unused_ = void, typename = traits::EnableEqualSize<Rows, Columns, Unused_>>
+	constexpr PaddedMatrix &operator*=(const PaddedMatrix &other)
+	{
+		(*this) = (*this) * other;
+		return *this;
+	}
+
+	///
+	/// Multiplies the logical elements only: multiplying the zero padding by an infinite or NaN \a scalar would fill it with NaN.
+	///
+	constexpr PaddedMatrix &operator*=(const ValueType scalar)
+	{
+		for (std::size_t rowIndex = 0u; rowIndex < Rows; ++rowIndex)
+		{
+			ValueType * const row = this->rowData(rowIndex);
+
+			for (std::size_t columnIndex = 0u; columnIndex < Columns; ++columnIndex)
+			{
+				row[columnIndex] *= scalar;
+			}
+		}
+
+		return *this;
+	}
+
+	///
+	/// Divides the logical elements only: dividing the zero padding by a zero \a scalar would fill it with NaN.
+	///
+	constexpr PaddedMatrix &operator/=(const ValueType scalar)
+	{
+		for (std::size_t rowIndex = 0u; rowIndex < Rows; ++rowIndex)
+		{
+			ValueType * const row = this->rowData(rowIndex);
+
+			for (std::size_t columnIndex = 0u; columnIndex < Columns; ++columnIndex)
+			{
+				row[columnIndex] /= scalar;
+			}
+		}
+
+		return *this;
+	}
+
+private:
+	alignas (detail::storageAlignment<ValueType, Rows * detail::paddedStride<ValueType, Columns>>) ValueType _data[Rows * detail::paddedStride<ValueType, Columns>] = {};
+
+	constexpr ValueType *rowData(const std::size_t rowIndex)
+	{
+		return &this->_data[rowIndex * PaddedMatrix::stride()];
+	}
+
+	constexpr const ValueType *rowData(const std::size_t rowIndex) const
+	{
+		return &this->_data[rowIndex * PaddedMatrix::stride()];
+	}
+
+#if defined(ND_MATH_VECTOR_SHUFFLE)
+	detail::QuadRegister<ValueType> quad() const
+	{
+		detail::QuadRegister<ValueType> returnValue;
+		std::memcpy(&returnValue, this->_data, sizeof (returnValue));
+		return returnValue;
+	}
+#endif
+
+	template <typename Expression>
+	constexpr void assign(const MatrixExpression<Expression, ValueType, Rows, Columns> &expression)
+	{
+		for (std::size_t rowIndex = 0u; rowIndex < Rows; ++rowIndex)
+		{
+			ValueType * const row = this->rowData(rowIndex);
+
+			for (std::size_t columnIndex = 0u; columnIndex < Columns; ++columnIndex)
+			{
+				row[columnIndex] = expression.element(rowIndex * Columns + columnIndex);
+			}
+		}
+	}
+};
+
+///
+/// Computes the product of \a left and \a right into \a result. Every row of the result is accumulated from whole padded rows of \a right,
+/// so the inner loop runs over full, aligned vector registers; large products are handed to the blocked kernel.
+///
+template <typename ValueType, std::size_t L, std::size_t M, std::size_t N>
+constexpr void mul(PaddedMatrix<ValueType, L, N> &result, const PaddedMatrix<ValueType, L, M> &left, const PaddedMatrix<ValueType, M, N> &right)
+{
+	using Blocking = detail::GemmBlocking<ValueType, L, M, N>;
+
+	result.setZero();
+
+	if constexpr (Blocking::enabled)
+	{
+		if (!std::is_constant_evaluated())
+		{
+			detail::gemm<Blocking>(L, N, M, left.data(), left.stride(), right.data(), right.stride(), result.data(), result.stride());
+			return;
+		}
+	}
+
+	for (std::size_t i = 0u; i < L; ++i)
+	{
+		ValueType * const resultRow = result.data() + i * result.stride();
+
+		for (std::size_t k = 0u; k < M; ++k)
+		{
+			const ValueType			leftValue	= left.data()[i * left.stride() + k];
+			const ValueType * const	rightRow	= right.data() + k * right.stride();
+
+			for (std::size_t j = 0u; j < PaddedMatrix<ValueType, M, N>::stride(); ++j)
+			{
+				resultRow[j] += leftValue * rightRow[j];
+			}
+		}
+	}
+}
+
+template <typename ValueType, std::size_t L, std::size_t M, std::size_t N>
+constexpr PaddedMatrix<ValueType, L, N> operator*(const PaddedMatrix<ValueType, L, M> &left, const PaddedMatrix<ValueType, M, N> &right)
+{
+	PaddedMatrix<ValueType, L, N> returnValue;
+
+	mul(returnValue, left, right);
+
+	return returnValue;
+}
+
+template <typename ValueType, std::size_t Rows, std::size_t Columns>
+constexpr MatrixView<ValueType> view(PaddedMatrix<ValueType, Rows, Columns> &matrix)
+{
+	return MatrixView<ValueType>{matrix.data(), Rows, Columns, matrix.stride()};
+}
+
+template <typename ValueType, std::size_t Rows, std::size_t Columns>
+constexpr MatrixView<const ValueType> view(const PaddedMatrix<ValueType, Rows, Columns> &matrix)
+{
+	return MatrixView<const ValueType>{matrix.data(), Rows, Columns, matrix.stride()};
+}
+
+template <typename ValueType, std::size_t Rows, std::size_t Columns>
+std::ostream &operator<<(std::ostream &stream, const PaddedMatrix<ValueType, Rows, Columns> &matrix)
+{
+	return (stream << matrix.eval());
+}
+
+// Matrices
+template <typename T>
+using PaddedMatrix4x4 = PaddedMatrix<T, 4u, 4u>;
+
+template <typename T>
+using PaddedMatrix3x3 = PaddedMatrix<T, 3u, 3u>;
+
+// Vectors
+template <typename T, std::size_t Order>
+using PaddedVector = PaddedMatrix<T, 1u, Order>;
+
+template <typename T>
+using PaddedVector4 = PaddedVector<T, 4u>;
+
+template <typename T>
+using PaddedVector3 = PaddedVector<T, 3u>;
+
+// Short aliases
+using PaddedMatrix4x4_f	= PaddedMatrix4x4<float>;
+using PaddedMatrix3x3_f	= PaddedMatrix3x3<float>;
+
+using PaddedMatrix4x4_d	= PaddedMatrix4x4<double>;
+using PaddedMatrix3x3_d	= PaddedMatrix3x3<double>;
+
+using PaddedVector4_f	= PaddedVector4<float>;
+using PaddedVector3_f	= PaddedVector3<float>;
+
+using PaddedVector4_d	= PaddedVector4<double>;
+using PaddedVector3_d	= PaddedVector3<double>;
+
+} // namespace nd::math
+
+#endif // ND_MATH_PADDED_MATRIX_HPP
@@ -0,0 +1,486 @@
+#ifndef ND_MATH_QUATERNION_SOA_HPP
+#define ND_MATH_QUATERNION_SOA_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+#include "quaternion.hpp"
+#include "threadpool.hpp"
+#include "vectorsoa.hpp"
+
+namespace nd::math
+{
+
+///
+/// Container of quaternions storing each component in its own array, real part first, so the batch kernels load a vector register of every
+/// component instead of gathering them from an array of \ref Quaternion.
+///
+/// The components are kept in a \ref VectorSoA of four dimensional vectors, the representation \ref rotate and \ref toRotationMatrices take
+/// quaternions in, and \ref view exposes them to those and all other vector kernels such as \ref normalize.
+///
+template <typename ValueType, typename Layout = layout::SoA>
+class QuaternionSoA
+{
+public:
+	using QuaternionType	= Quaternion<ValueType>;
+	using value_type		= QuaternionType;
+	using size_type			= std::size_t;
+	using View				= VectorSoAView<ValueType, 4u, Layout>;
+	using ConstView			= VectorSoAView<const ValueType, 4u, Layout>;
+
+	QuaternionSoA() = default;
+
+	///
+	/// Creates \a size zero initialized quaternions. Like for \ref resize, these are not the identity.
+	///
+	explicit QuaternionSoA(const std::size_t size) :
+		_components(size)
+	{
+	}
+
+	///
+	/// Creates a copy of the quaternions \a quaternions, see \ref assign.
+	///
+	explicit QuaternionSoA(const std::span<const QuaternionType> quaternions)
+	{
+		this->assign(quaternions);
+	}
+
+	QuaternionSoA clone() const
+	{
+		QuaternionSoA returnValue;
+		returnValue._components = this->_components.clone();
+		return returnValue;
+	}
+
+	std::size_t size() const
+	{
+		return this->_components.size();
+	}
+
+	std::size_t capacity() const
+	{
+		return this->_components.capacity();
+	}
+
+	bool empty() const
+	{
+		return this->_components.empty();
+	}
+
+	void reserve(const std::size_t capacity)
+	{
+		this->_components.reserve(capacity);
+	}
+
+	///
+	/// Changes the number of quaternions to \a size. Added quaternions are zero initialized.
+	///
+	void resize(const std::size_t size)
+	{
+		this->_components.resize(size);
+	}
+
+	void clear()
+	{
+		this->_components.clear();
+	}
+
+	///
+	/// Replaces all quaternions by the array of structures \a quaternions, whose components are separated with register shuffles like by
+	/// \ref VectorSoA::assign.
+	///
+	void assign(const std::span<const QuaternionType> quaternions)
+	{
+		static_assert(std::is_standard_layout_v<QuaternionType> & (sizeof (QuaternionType) == sizeof (Vector4<ValueType>)),
+					  "Quaternions have to be packed");
+
+		// A quaternion is its vector of components, so the array is one of packed row vectors
+		this->_components.assign(std::span<const Vector4<ValueType>>{reinterpret_cast<const Vector4<ValueType> *>(quaternions.data()),
+																	 quaternions.size()});
+	}
+
+	void push_back(const QuaternionType &quaternion)
+	{
+		this->_components.emplace_back(quaternion[0u], quaternion[1u], quaternion[2u], quaternion[3u]);
+	}
+
+	void pop_back()
+	{
+		this->_components.pop_back();
+	}
+
+	///
+	/// Gathers the components of quaternion \a index.
+	///
+	QuaternionType operator[](const std::size_t index) const
+	{
+		const auto components = this->_components[index];
+		return QuaternionType{components[0u], components[1u], components[2u], components[3u]};
+	}
+
+	void set(const std::size_t index, const QuaternionType &quaternion)
+	{
+		const auto components = this->_components[index];
+
+		for (std::size_t component = 0u; component < 4u; ++component)
+		{
+			components[component] = quaternion[component];
+		}
+	}
+
+	View view()
+	{
+		return this->_components.view();
+	}
+
+	ConstView view() const
+	{
+		return this->_components.view();
+	}
+
+	View view(const std::size_t index, const std::size_t count)
+	{
+		return this->_components.view(index, count);
+	}
+
+	ConstView view(const std::size_t index, const std::size_t count) const
+	{
+		return this->_components.view(index, count);
+	}
+
+private:
+	VectorSoA<ValueType, 4u, Layout> _components;
+};
+
+///
+/// Writes the vectors \a vectors rotated by the unit quaternion \a rotation to \a result, which may be \a vectors itself, see
+/// \ref Quaternion::rotate.
+///
+template <typename ValueType, typename Layout>
+void rotate(const Quaternion<ValueType> &rotation, const typename VectorSoAView<ValueType, 3u, Layout>::ConstView vectors,
+			const VectorSoAView<ValueType, 3u, Layout> result)
+{
+	using Mapping = typename VectorSoAView<ValueType, 3u, Layout>::Mapping;
+
+	assert(vectors.size() == result.size());
+
+	const std::size_t head = detail::batchHead<Mapping>(vectors.size(), vectors.offset(), result.offset());
+
+	detail::batch<ValueType, Mapping::lanes>(head, vectors.size(), [w = rotation[0u], a = rotation[1u], b = rotation[2u], c = rotation[3u], vectors,
+																	result](const std::size_t index, auto lane)
+	{
+		using Lane = decltype(lane);
+
+		Lane x = detail::batchLoad<Lane>(vectors.data(0u, index));
+		Lane y = detail::batchLoad<Lane>(vectors.data(1u, index));
+		Lane z = detail::batchLoad<Lane>(vectors.data(2u, index));
+
+		detail::rotate(w, a, b, c, x, y, z);
+
+		detail::batchStore(result.data(0u, index), x);
+		detail::batchStore(result.data(1u, index), y);
+		detail::batchStore(result.data(2u, index), z);
+	});
+}
+
+template <typename ValueType, typename Layout>
+void rotate(const Quaternion<ValueType> &rotation, const VectorSoA<ValueType, 3u, Layout> &vectors, VectorSoA<ValueType, 3u, Layout> &result)
+{
+	rotate(rotation, vectors.view(), result.view());
+}
+
+template <typename ValueType, typename Layout>
+void rotate(const Quaternion<ValueType> &rotation, VectorSoA<ValueType, 3u, Layout> &vectors)
+{
+	rotate(rotation, vectors.view(), vectors.view());
+}
+
+///
+/// Writes every vector of \a vectors rotated by the corresponding unit quaternion of \a rotations to \a result, which may be \a vectors
+/// itself. Quaternions are stored as four component vectors with the real part first, so they load into registers like the vectors do.
+///
+template <typename ValueType, typename Layout>
+void rotate(const typename VectorSoAView<ValueType, 4u, Layout>::ConstView rotations,
+			const typename VectorSoAView<ValueType, 3u, Layout>::ConstView vectors, const VectorSoAView<ValueType, 3u, Layout> result)
+{
+	using Mapping = typename VectorSoAView<ValueType, 3u, Layout>::Mapping;
+
+	assert((rotations.size() == vectors.size()) & (vectors.size() == result.size()));
+
+	const std::size_t head = detail::batchHead<Mapping>(vectors.size(), vectors.offset(), rotations.offset(), result.offset());
+
+	detail::batch<ValueType, Mapping::lanes>(head, vectors.size(), [rotations, vectors, result](const std::size_t index, auto lane)
+	{
+		using Lane = decltype(lane);
+
+		const Lane w = detail::batchLoad<Lane>(rotations.data(0u, index));
+		const Lane a = detail::batchLoad<Lane>(rotations.data(1u, index));
+		const Lane b = detail::batchLoad<Lane>(rotations.data(2u, index));
+		const Lane c = detail::batchLoad<Lane>(rotations.data(3u, index));
+
+		Lane x = detail::batchLoad<Lane>(vectors.data(0u, index));
+		Lane y = detail::batchLoad<Lane>(vectors.data(1u, index));
+		Lane z = detail::batchLoad<Lane>(vectors.data(2u, index));
+
+		detail::rotate(w, a, b, c, x, y, z);
+
+		detail::batchStore(result.data(0u, index), x);
+		detail::batchStore(result.data(1u, index), y);
+		detail::batchStore(result.data(2u, index), z);
+	});
+}
+
+template <typename ValueType, typename Layout>
+void rotate(const VectorSoA<ValueType, 4u, Layout> &rotations, const VectorSoA<ValueType, 3u, Layout> &vectors,
+			VectorSoA<ValueType, 3u, Layout> &result)
+{
+	rotate(rotations.view(), vectors.view(), result.view());
+}
+
+template <typename ValueType, typename Layout>
+void rotate(const VectorSoA<ValueType, 4u, Layout> &rotations, VectorSoA<ValueType, 3u, Layout> &vectors)
+{
+	rotate(rotations.view(), vectors.view(), vectors.view());
+}
+
+///
+/// Writes the rotation matrices of the unit quaternions \a rotations, stored with the real part first like for \ref rotate, to \a result,
+/// see \ref Quaternion::toRotationMatrix3 and \ref Quaternion::toRotationMatrix. Matrices are contiguous, so \a result can be uploaded as
+/// per instance data directly.
+///
+template <typename ValueType, typename Layout, std::size_t Size, typename = std::enable_if_t<(Size == 3u) | (Size == 4u)>>
+void toRotationMatrices(const VectorSoAView<ValueType, 4u, Layout> rotations, const std::span<Matrix<std::remove_const_t<ValueType>, Size, Size>> result)
+{
+	using Element	= std::remove_const_t<ValueType>;
+	using Mapping	= typename VectorSoAView<ValueType, 4u, Layout>::Mapping;
+
+	assert(rotations.size() == result.size());
+
+	const std::size_t head = detail::batchHead<Mapping>(rotations.size(), rotations.offset());
+
+	detail::batch<Element, Mapping::lanes>(head, rotations.size(), [rotations, result](const std::size_t index, auto lane)
+	{
+		using Lane = decltype(lane);
+
+		constexpr std::size_t lanes = sizeof (Lane) / sizeof (Element);
+
+		const Lane w = detail::batchLoad<Lane>(rotations.data(0u, index));
+		const Lane x = detail::batchLoad<Lane>(rotations.data(1u, index));
+		const Lane y = detail::batchLoad<Lane>(rotations.data(2u, index));
+		const Lane z = detail::batchLoad<Lane>(rotations.data(3u, index));
+
+		Lane entries[9u];
+		detail::rotationMatrix(w, x, y, z, entries);
+
+		// Matrices interleave the entries, so each register is spilled once and the lanes are gathered from there
+		Element values[9u][lanes];
+
+		for (std::size_t entry = 0u; entry < 9u; ++entry)
+		{
+			detail::batchStore(values[entry], entries[entry]);
+		}
+
+		for (std::size_t element = 0u; element < lanes; ++element)
+		{
+			Element * const matrix = result[index + element].data();
+
+			for (std::size_t row = 0u; row < Size; ++row)
+			{
+				for (std::size_t column = 0u; column < Size; ++column)
+				{
+					matrix[row * Size + column] = ((row < 3u) & (column < 3u)) ? values[row * 3u + column][element] : Element(row == column);
+				}
+			}
+		}
+	});
+}
+
+template <typename ValueType, typename Layout, std::size_t Size, typename = std::enable_if_t<(Size == 3u) | (Size == 4u)>>
+void toRotationMatrices(const VectorSoA<ValueType, 4u, Layout> &rotations, const std::span<Matrix<ValueType, Size, Size>> result)
+{
+	toRotationMatrices(rotations.view(), result);
+}
+
+namespace detail
+{
+
+///
+/// Blends every quaternion of \a from with the one of \a to along the shorter arc by the corresponding weight of \a weights and renormalizes
+/// the result into \a result, in chunks of about \a grainSize quaternions on \ref ThreadPool::instance.
+///
+/// The weights of both endpoints come from \a interpolation, called with the dot product of the quaternions after \a to has been flipped to
+/// the hemisphere of \a from, so it is never negative, and the weight of \a to. Its arguments are either scalars or vector registers.
+///
+template <typename ValueType, typename Layout, typename Interpolation>
+inline void blend(const typename VectorSoAView<ValueType, 4u, Layout>::ConstView from,
+				  const typename VectorSoAView<ValueType, 4u, Layout>::ConstView to, const std::span<const ValueType> weights,
+				  const VectorSoAView<ValueType, 4u, Layout> result, const Interpolation &interpolation, const std::size_t grainSize)
+{
+	using Mapping = typename VectorSoAView<ValueType, 4u, Layout>::Mapping;
+
+	assert((from.size() == to.size()) & (from.size() == weights.size()) & (from.size() == result.size()));
+
+	const std::size_t chunkSize		= detail::chunkSize<Mapping>(grainSize);
+	const std::size_t chunkCount	= (result.size() + chunkSize - 1u) / chunkSize;
+
+	ThreadPool::instance().parallelFor(chunkCount, [&](const std::size_t chunk)
+	{
+		const std::size_t index = chunk * chunkSize;
+		const std::size_t count = std::min(chunkSize, result.size() - index);
+
+		const auto left		= from.subview(index, count);
+		const auto right	= to.subview(index, count);
+		const auto factors	= weights.subspan(index, count);
+		const auto output	= result.subview(index, count);
+
+		const std::size_t head = detail::batchHead<Mapping>(count, left.offset(), right.offset(), output.offset());
+
+		detail::batch<ValueType, Mapping::lanes>(head, count, [left, right, factors, output, &interpolation](const std::size_t element, auto lane)
+		{
+			using Lane = decltype(lane);
+
+			Lane	fromComponents[4u];
+			Lane	toComponents[4u];
+			Lane	cosine = {};
+
+			for (std::size_t component = 0u; component < 4u; ++component)
+			{
+				fromComponents[component]	= detail::batchLoad<Lane>(left.data(component, element));
+				toComponents[component]		= detail::batchLoad<Lane>(right.data(component, element));
+				cosine						+= fromComponents[component] * toComponents[component];
+			}
+
+			// A quaternion and its negation are the same rotation; flipping onto the hemisphere of from takes the shorter arc
+			const Lane sign		= (cosine < ValueType{}) ? Lane{} - ValueType(1) : Lane{} + ValueType(1);
+			const Lane weight	= detail::batchLoad<Lane>(factors.data() + element);
+
+			Lane fromWeight;
+			Lane toWeight;
+			interpolation(Lane(cosine * sign), weight, fromWeight, toWeight);
+			toWeight *= sign;
+
+			Lane blended[4u];
+			Lane sum = {};
+
+			for (std::size_t component = 0u; component < 4u; ++component)
+			{
+				blended[component]	= fromComponents[component] * fromWeight + toComponents[component] * toWeight;
+				sum					+= blended[component] * blended[component];
+			}
+
+			const Lane length = detail::batchSquareRoot<ValueType>(sum);
+
+			for (std::size_t component = 0u; component < 4u; ++component)
+			{
+				detail::batchStore(output.data(component, element), Lane(blended[component] / length));
+			}
+		});
+	});
+}
+
+} // namespace detail
+
+///
+/// Writes the quaternions of \a from and \a to linearly interpolated by the corresponding \a weights along the shorter arc and renormalized
+/// to \a result, which may be one of the operands, see \ref nlerp(const Quaternion<ValueType> &, const Quaternion<ValueType> &, ValueType).
+///
+/// Like all blends it processes chunks of about \a grainSize quaternions in parallel, so blending all bones of many poses at once scales with
+/// the threads of \ref ThreadPool::instance while small batches stay on the calling thread.
+///
+template <typename ValueType, typename Layout>
+void nlerp(const typename VectorSoAView<ValueType, 4u, Layout>::ConstView from, const typename VectorSoAView<ValueType, 4u, Layout>::ConstView to,
+		   const std::span<const std::type_identity_t<ValueType>> weights, const VectorSoAView<ValueType, 4u, Layout> result,
+		   const std::size_t grainSize = detail::parallelGrainSize)
+{
+	detail::blend<ValueType, Layout>(from, to, weights, result, [](const auto &, const auto &weight, auto &fromWeight, auto &toWeight)
+	{
+		fromWeight	= ValueType(1) - weight;
+		toWeight	= weight;
+	}, grainSize);
+}
+
+template <typename ValueType, typename Layout>
+void nlerp(const QuaternionSoA<ValueType, Layout> &from, const QuaternionSoA<ValueType, Layout> &to,
+		   const std::span<const std::type_identity_t<ValueType>> weights, QuaternionSoA<ValueType, Layout> &result,
+		   const std::size_t grainSize = detail::parallelGrainSize)
+{
+	nlerp(from.view(), to.view(), weights, result.view(), grainSize);
+}
+
+///
+/// Writes the quaternions of \a from and \a to spherically interpolated by the corresponding \a weights along the shorter arc to \a result,
+/// see \ref nlerp for the parameters. Everything but the angles and their sines is vectorized; the trigonometric functions are evaluated
+/// lane by lane, use \ref fastSlerp to avoid them.
+///
+template <typename ValueType, typename Layout>
+void slerp(const typename VectorSoAView<ValueType, 4u, Layout>::ConstView from, const typename VectorSoAView<ValueType, 4u, Layout>::ConstView to,
+		   const std::span<const std::type_identity_t<ValueType>> weights, const VectorSoAView<ValueType, 4u, Layout> result,
+		   const std::size_t grainSize = detail::parallelGrainSize)
+{
+	detail::blend<ValueType, Layout>(from, to, weights, result, [](const auto &cosine, const auto &weight, auto &fromWeight, auto &toWeight)
+	{
+		using Lane = std::remove_cvref_t<decltype(cosine)>;
+
+		constexpr std::size_t lanes = sizeof (Lane) / sizeof (ValueType);
+
+		ValueType cosines[lanes];
+		ValueType factors[lanes];
+		ValueType fromWeights[lanes];
+		ValueType toWeights[lanes];
+
+		detail::batchStore(cosines, cosine);
+		detail::batchStore(factors, weight);
+
+		for (std::size_t element = 0u; element < lanes; ++element)
+		{
+			detail::slerpWeights(cosines[element], factors[element], fromWeights[element], toWeights[element]);
+		}
+
+		fromWeight	= detail::batchLoad<Lane>(fromWeights);
+		toWeight	= detail::batchLoad<Lane>(toWeights);
+	}, grainSize);
+}
+
+template <typename ValueType, typename Layout>
+void slerp(const QuaternionSoA<ValueType, Layout> &from, const QuaternionSoA<ValueType, Layout> &to,
+		   const std::span<const std::type_identity_t<ValueType>> weights, QuaternionSoA<ValueType, Layout> &result,
+		   const std::size_t grainSize = detail::parallelGrainSize)
+{
+	slerp(from.view(), to.view(), weights, result.view(), grainSize);
+}
+
+///
+/// Approximates \ref slerp with the polynomial of \ref detail::slerpRatio, which is evaluated in vector registers like the rest of the blend.
+///
+template <typename ValueType, typename Layout>
+void fastSlerp(const typename VectorSoAView<ValueType, 4u, Layout>::ConstView from,
+			   const typename VectorSoAView<ValueType, 4u, Layout>::ConstView to, const std::span<const std::type_identity_t<ValueType>> weights,
+			   const VectorSoAView<ValueType, 4u, Layout> result, const std::size_t grainSize = detail::parallelGrainSize)
+{
+	detail::blend<ValueType, Layout>(from, to, weights, result, [](const auto &cosine, const auto &weight, auto &fromWeight, auto &toWeight)
+	{
+		using Lane = std::remove_cvref_t<decltype(cosine)>;
+
+		detail::slerpRatio<ValueType>(cosine, Lane(ValueType(1) - weight), fromWeight);
+		detail::slerpRatio<ValueType>(cosine, weight, toWeight);
+	}, grainSize);
+}
+
+template <typename ValueType, typename Layout>
+void fastSlerp(const QuaternionSoA<ValueType, Layout> &from, const QuaternionSoA<ValueType, Layout> &to,
+			   const std::span<const std::type_identity_t<ValueType>> weights, QuaternionSoA<ValueType, Layout> &result,
+			   const std::size_t grainSize = detail::parallelGrainSize)
+{
+	fastSlerp(from.view(), to.view(), weights, result.view(), grainSize);
+}
+
+using QuaternionSoA_f = QuaternionSoA<float>;
+using QuaternionSoA_d = QuaternionSoA<double>;
+
+} // namespace nd::math
+
+#endif // ND_MATH_QUATERNION_SOA_HPP
@@ -0,0 +1,138 @@
+#ifndef ND_MATH_SIMD_HPP
+#define ND_MATH_SIMD_HPP
+
+#include <algorithm>
+#include <cstddef>
+
+#if defined(__AVX512F__)
+#define ND_MATH_SIMD_AVX512
+#endif
+
+#if defined(__AVX__)
+#define ND_MATH_SIMD_AVX
+#endif
+
+#if defined(__AVX2__)
+#define ND_MATH_SIMD_AVX2
+#endif
+
+#if defined(__FMA__)
+#define ND_MATH_SIMD_FMA
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define ND_MATH_SIMD_SSE
+#endif
+
+#if defined(ND_MATH_SIMD_SSE)
+#include <immintrin.h>
+#endif
+
+// Arbitrary lane permutations of GCC vector extension types
+#if defined(__GNUC__) && defined(__has_builtin)
+#if __has_builtin(__builtin_shufflevector)
+#define ND_MATH_VECTOR_SHUFFLE
+#endif
+#endif
+
+namespace nd::math::simd
+{
+
+///
+/// Size of the widest vector register available for the target architecture in bytes.
+///
+#if defined(ND_MATH_SIMD_AVX512)
+inline constexpr std::size_t registerSize	= 64u;
+inline constexpr std::size_t registerCount	= 32u;
+#elif defined(ND_MATH_SIMD_AVX)
+inline constexpr std::size_t registerSize	= 32u;
+inline constexpr std::size_t registerCount	= 16u;
+#else
+inline constexpr std::size_t registerSize	= 16u;
+inline constexpr std::size_t registerCount	= 16u;
+#endif
+
+inline constexpr std::size_t cacheLineSize	= 64u;
+inline constexpr std::size_t l1CacheSize	= 32u * 1024u;
+inline constexpr std::size_t l2CacheSize	= 256u * 1024u;
+
+///
+/// Number of \a ValueType elements fitting into one vector register.
+///
+template <typename ValueType>
+inline constexpr std::size_t width = std::max<std::size_t>(registerSize / sizeof (ValueType), 1u);
+
+#if defined(ND_MATH_SIMD_SSE)
+///
+/// Returns $a b + c$, fused if the target supports FMA.
+///
+inline __m128 multiplyAdd(const __m128 a, const __m128 b, const __m128 c)
+{
+#if defined(ND_MATH_SIMD_FMA)
+	return _mm_fmadd_ps(a, b, c);
+#else
+	return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+
+inline __m128d multiplyAdd(const __m128d a, const __m128d b, const __m128d c)
+{
+#if defined(ND_MATH_SIMD_FMA)
+	return _mm_fmadd_pd(a, b, c);
+#else
+	return _mm_add_pd(_mm_mul_pd(a, b), c);
+#endif
+}
+
+///
+/// Stores the lanes of \a vector to \a destination one by one, so later loads of single lanes are forwarded from the stores. Subscripting
+/// registers is a GCC extension; other compilers use an unaligned vector store.
+///
+inline void storeLanes(float *destination, const __m128 vector)
+{
+#if defined(__GNUC__)
+	for (std::size_t index = 0u; index < 4u; ++index)
+	{
+		destination[index] = vector[index];
+	}
+#else
+	_mm_storeu_ps(destination, vector);
+#endif
+}
+#endif
+
+#if defined(ND_MATH_SIMD_AVX)
+inline __m256 multiplyAdd(const __m256 a, const __m256 b, const __m256 c)
+{
+#if defined(ND_MATH_SIMD_FMA)
+	return _mm256_fmadd_ps(a, b, c);
+#else
+	return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+
+inline __m256d multiplyAdd(const __m256d a, const __m256d b, const __m256d c)
+{
+#if defined(ND_MATH_SIMD_FMA)
+	return _mm256_fmadd_pd(a, b, c);
+#else
+	return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+}
+
+inline void storeLanes(double *destination, const __m256d vector)
+{
+#if defined(__GNUC__)
+	for (std::size_t index = 0u; index < 4u; ++index)
+	{
+		destination[index] = vector[index];
+	}
+#else
+	_mm256_storeu_pd(destination, vector);
+#endif
+}
+#endif
+
+} // namespace nd::math::simd
+
+#endif // ND_MATH_SIMD_HPP
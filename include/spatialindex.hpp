@@ -0,0 +1,644 @@
+#ifndef ND_MATH_SPATIAL_INDEX_HPP
+#define ND_MATH_SPATIAL_INDEX_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "boundingbox.hpp"
+#include "matrix.hpp"
+#include "simd.hpp"
+#include "threadpool.hpp"
+#include "vectorsoa.hpp"
+
+namespace nd::math
+{
+
+///
+/// Bounding volume hierarchy over the points of a \ref VectorSoA answering nearest neighbour, radius and ray queries.
+///
+/// The index refers to the points instead of copying them and only stores a permutation of their indices, so the container has to outlive
+/// the index and must not change its size; \ref refit updates the bounds after points moved, \ref build rebuilds the hierarchy.
+///
+/// Nodes are split at the median along the longest axis of their bounds, which yields a balanced tree whose shape only depends on the number
+/// of points. Nodes are stored depth-first in a single array: the left child directly follows its parent and only the index of the right
+/// child is stored, so a node of three dimensional float points occupies half a cache line and traversals walk memory mostly forward. Since
+/// the size of every subtree is known up front, subtrees are built and refitted in parallel on \ref ThreadPool::instance.
+///
+template <typename ValueType, std::size_t Order, typename Layout = layout::SoA>
+class SpatialIndex
+{
+	static_assert(std::is_floating_point_v<ValueType>, "Spatial indices require floating point coordinates");
+
+public:
+	using Points		= VectorSoA<ValueType, Order, Layout>;
+	using VectorType	= ColumnVector<ValueType, Order>;
+	using BoxType		= BoundingBox<ValueType, Order>;
+
+	///
+	/// Maximum number of points per leaf: one vector register, so the distances to all points of a leaf are computed at once.
+	///
+	static constexpr std::size_t leafSize = std::max<std::size_t>(simd::width<ValueType>, 4u);
+
+	///
+	/// Index returned by queries that found no point.
+	///
+	static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+	///
+	/// Closest point hit by a ray and the ray parameter of its projection onto the ray, see \ref intersect.
+	///
+	struct Hit
+	{
+		std::size_t	index		= none;
+		ValueType	distance	= std::numeric_limits<ValueType>::infinity();
+	};
+
+	///
+	/// Indexes \a points, which are referenced rather than copied and therefore have to outlive the index.
+	///
+	explicit SpatialIndex(const Points &points) :
+		_points(&points)
+	{
+		this->build();
+	}
+
+	SpatialIndex(Points &&points) = delete;
+
+	///
+	/// Rebuilds the hierarchy for the current points, which may have changed in number.
+	///
+	void build()
+	{
+		const std::size_t size = this->_points->size();
+
+		assert(size <= std::numeric_limits<std::uint32_t>::max());
+
+		this->_indices.resize(size);
+		std::iota(this->_indices.begin(), this->_indices.end(), std::uint32_t{0u});
+
+		this->_nodes.assign((size > 0u) ? SpatialIndex::nodeCount(size) : 0u, Node{});
+
+		if (size > 0u)
+		{
+			this->buildNode(0u, 0u, size);
+		}
+	}
+
+	///
+	/// Updates the bounds of all nodes after points moved, keeping the hierarchy. Queries stay exact, but they slow down as the points drift
+	/// away from the spatial order the hierarchy was built for; rebuild once they moved far.
+	///
+	void refit()
+	{
+		assert(this->_indices.size() == this->_points->size());
+
+		if (!this->_nodes.empty())
+		{
+			this->refitNode(0u, this->_indices.size());
+		}
+	}
+
+	std::size_t size() const
+	{
+		return this->_indices.size();
+	}
+
+	bool empty() const
+	{
+		return this->_indices.empty();
+	}
+
+	///
+	/// Returns the bounding box of all points.
+	///
+	BoxType bounds() const
+	{
+		return this->_nodes.empty() ? BoxType::empty() : this->_nodes.front().bounds;
+	}
+
+	///
+	/// Returns the index of the point closest to \a query, or \ref none if there are no points.
+	///
+	std::size_t nearest(const VectorType &query) const
+	{
+		std::size_t	index			= none;
+		ValueType	squareDistance	= std::numeric_limits<ValueType>::infinity();
+
+		this->nearest(query, std::span<std::size_t>{&index, 1u}, std::span<ValueType>{&squareDistance, 1u});
+
+		return index;
+	}
+
+	///
+	/// Writes the indices of the points closest to \a query to \a indices and their square distances to \a squareDistances, ordered by
+	/// increasing distance. Searches as many neighbours as \a indices holds and returns the number found, which is less if there are fewer
+	/// points.
+	///
+	std::size_t nearest(const VectorType &query, const std::span<std::size_t> indices, const std::span<ValueType> squareDistances) const
+	{
+		assert(indices.size() == squareDistances.size());
+
+		const std::size_t k = indices.size();
+
+		std::size_t found = 0u;
+
+		if ((k == 0u) | this->_nodes.empty())
+		{
+			return found;
+		}
+
+		Entry stack[SpatialIndex::_stackSize];
+		std::size_t depth = 0u;
+
+		stack[depth++] = Entry{0u, SpatialIndex::squareDistance(this->_nodes.front().bounds, query)};
+
+		while (depth > 0u)
+		{
+			const Entry entry = stack[--depth];
+
+			// Neighbours found meanwhile may exclude nodes pushed before
+			if ((found == k) && (entry.distance >= squareDistances[k - 1u]))
+			{
+				continue;
+			}
+
+			const Node &node = this->_nodes[entry.node];
+
+			if (node.count > 0u)
+			{
+				ValueType distances[leafSize];
+				this->leafSquareDistances(node, query, distances);
+
+				for (std::size_t point = 0u; point < node.count; ++point)
+				{
+					if ((found == k) && (distances[point] >= squareDistances[k - 1u]))
+					{
+						continue;
+					}
+
+					// Insertion into the sorted neighbours, dropping the farthest once all are found
+					std::size_t position = std::min(found, k - 1u);
+
+					for (; (position > 0u) && (squareDistances[position - 1u] > distances[point]); --position)
+					{
+						indices[position]			= indices[position - 1u];
+						squareDistances[position]	= squareDistances[position - 1u];
+					}
+
+					indices[position]			= this->_indices[node.first + point];
+					squareDistances[position]	= distances[point];
+					found						= std::min(found + 1u, k);
+				}
+			}
+			else
+			{
+				const std::uint32_t left			= entry.node + 1u;
+				const std::uint32_t right			= node.first;
+				const ValueType		leftDistance	= SpatialIndex::squareDistance(this->_nodes[left].bounds, query);
+				const ValueType		rightDistance	= SpatialIndex::squareDistance(this->_nodes[right].bounds, query);
+
+				// The nearer child is popped first
+				if (leftDistance <= rightDistance)
+				{
+					stack[depth++] = Entry{right, rightDistance};
+					stack[depth++] = Entry{left, leftDistance};
+				}
+				else
+				{
+					stack[depth++] = Entry{left, leftDistance};
+					stack[depth++] = Entry{right, rightDistance};
+				}
+			}
+		}
+
+		return found;
+	}
+
+	///
+	/// Writes the index of the point closest to every point of \a queries to \a result, answering chunks of queries in parallel.
+	///
+	/// Queries are processed in the order given, so sorting them spatially makes consecutive queries of a chunk traverse the same, cached
+	/// nodes.
+	///
+	template <typename QueryLayout>
+	void nearest(const VectorSoAView<const ValueType, Order, QueryLayout> queries, const std::span<std::size_t> result,
+				 const std::size_t grainSize = SpatialIndex::_queryGrainSize) const
+	{
+		assert(queries.size() == result.size());
+
+		const std::size_t chunkSize		= std::max<std::size_t>(grainSize, 1u);
+		const std::size_t chunkCount	= (queries.size() + chunkSize - 1u) / chunkSize;
+
+		ThreadPool::instance().parallelFor(chunkCount, [this, queries, result, chunkSize](const std::size_t chunk)
+		{
+			const std::size_t end = std::min(queries.size(), (chunk + 1u) * chunkSize);
+
+			for (std::size_t index = chunk * chunkSize; index < end; ++index)
+			{
+				result[index] = this->nearest(VectorType(queries[index]));
+			}
+		});
+	}
+
+	template <typename QueryLayout>
+	void nearest(const VectorSoA<ValueType, Order, QueryLayout> &queries, const std::span<std::size_t> result,
+				 const std::size_t grainSize = SpatialIndex::_queryGrainSize) const
+	{
+		this->nearest(queries.view(), result, grainSize);
+	}
+
+	///
+	/// Calls \a function with the index of every point within \a radius of \a center, in no particular order.
+	///
+	template <typename Function>
+	void forEachWithin(const VectorType &center, const ValueType radius, const Function &function) const
+	{
+		if (this->_nodes.empty())
+		{
+			return;
+		}
+
+		const ValueType squareRadius = radius * radius;
+
+		std::uint32_t stack[SpatialIndex::_stackSize];
+		std::size_t depth = 0u;
+
+		stack[depth++] = 0u;
+
+		while (depth > 0u)
+		{
+			const std::uint32_t	index	= stack[--depth];
+			const Node			&node	= this->_nodes[index];
+
+			if (SpatialIndex::squareDistance(node.bounds, center) > squareRadius)
+			{
+				continue;
+			}
+
+			if (node.count > 0u)
+			{
+				ValueType distances[leafSize];
+				this->leafSquareDistances(node, center, distances);
+
+				for (std::size_t point = 0u; point < node.count; ++point)
+				{
+					if (distances[point] <= squareRadius)
+					{
+						function(std::size_t{this->_indices[node.first + point]});
+					}
+				}
+			}
+			else
+			{
+				stack[depth++] = node.first;
+				stack[depth++] = index + 1u;
+			}
+		}
+	}
+
+	///
+	/// Returns the indices of all points within \a radius of \a center, in no particular order.
+	///
+	std::vector<std::size_t> within(const VectorType &center, const ValueType radius) const
+	{
+		std::vector<std::size_t> returnValue;
+
+		this->forEachWithin(center, radius, [&returnValue](const std::size_t index)
+		{
+			returnValue.push_back(index);
+		});
+
+		return returnValue;
+	}
+
+	///
+	/// Returns the first point along the ray from \a origin in \a direction whose distance to the ray is at most \a radius, treating points
+	/// as spheres of \a radius.
+	///
+	/// The hit distance is the ray parameter $t$ of the projection of the point onto the ray, in multiples of the length of \a direction; only
+	/// points projecting onto $[0, maximumDistance]$ are considered.
+	///
+	Hit intersect(const VectorType &origin, const VectorType &direction, const ValueType radius,
+				  const ValueType maximumDistance = std::numeric_limits<ValueType>::infinity()) const
+	{
+		Hit returnValue;
+
+		if (this->_nodes.empty())
+		{
+			return returnValue;
+		}
+
+		VectorType inverseDirection;
+
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			inverseDirection[order] = static_cast<ValueType>(1) / direction[order];
+		}
+
+		const ValueType inverseSquareLength	= static_cast<ValueType>(1) / SpatialIndex::dot(direction, direction);
+		const ValueType squareRadius		= radius * radius;
+
+		Entry stack[SpatialIndex::_stackSize];
+		std::size_t depth = 0u;
+
+		stack[depth++] = Entry{0u, SpatialIndex::entryDistance(this->_nodes.front().bounds, origin, inverseDirection, radius)};
+
+		while (depth > 0u)
+		{
+			const Entry entry = stack[--depth];
+
+			if (entry.distance > std::min(returnValue.distance, maximumDistance))
+			{
+				continue;
+			}
+
+			const Node &node = this->_nodes[entry.node];
+
+			if (node.count > 0u)
+			{
+				for (std::size_t point = 0u; point < node.count; ++point)
+				{
+					const std::size_t	index		= this->_indices[node.first + point];
+					const VectorType	offset		= VectorType((*this->_points)[index]) - origin;
+					const ValueType		distance	= SpatialIndex::dot(offset, direction) * inverseSquareLength;
+
+					if ((distance < ValueType{}) | (distance > maximumDistance) | (distance >= returnValue.distance))
+					{
+						continue;
+					}
+
+					const VectorType closest = offset - direction * distance;
+
+					if (SpatialIndex::dot(closest, closest) <= squareRadius)
+					{
+						returnValue = Hit{index, distance};
+					}
+				}
+			}
+			else
+			{
+				const std::uint32_t left			= entry.node + 1u;
+				const std::uint32_t right			= node.first;
+				const ValueType		leftDistance	= SpatialIndex::entryDistance(this->_nodes[left].bounds, origin, inverseDirection, radius);
+				const ValueType		rightDistance	= SpatialIndex::entryDistance(this->_nodes[right].bounds, origin, inverseDirection, radius);
+
+				if (leftDistance <= rightDistance)
+				{
+					stack[depth++] = Entry{right, rightDistance};
+					stack[depth++] = Entry{left, leftDistance};
+				}
+				else
+				{
+					stack[depth++] = Entry{left, leftDistance};
+					stack[depth++] = Entry{right, rightDistance};
+				}
+			}
+		}
+
+		return returnValue;
+	}
+
+private:
+	///
+	/// Node of the hierarchy: leaves store the range of their points in the permutation, inner nodes the index of their right child and a
+	/// count of zero.
+	///
+	struct Node
+	{
+		BoxType			bounds;
+		std::uint32_t	first	= 0u;
+		std::uint32_t	count	= 0u;
+	};
+
+	///
+	/// Node pending in a traversal stack along with a lower bound of the distance of its points, a square distance or a ray parameter.
+	///
+	struct Entry
+	{
+		std::uint32_t	node;
+		ValueType		distance;
+	};
+
+	// Balanced trees of 32 bit indices are at most 33 levels deep, and traversals push two children per level
+	static constexpr std::size_t _stackSize			= 2u * std::numeric_limits<std::uint32_t>::digits + 2u;
+	static constexpr std::size_t _parallelBuildSize	= 16384u;
+	static constexpr std::size_t _queryGrainSize	= 256u;
+
+	const Points				*_points	= nullptr;
+	std::vector<Node>			_nodes;
+	std::vector<std::uint32_t>	_indices;
+
+	///
+	/// Returns the number of nodes of the subtree over \a count points.
+	///
+	static constexpr std::size_t nodeCount(const std::size_t count)
+	{
+		std::size_t returnValue = 0u;
+
+		// Halves differ by at most one point, so every level consists of subtrees of some size and of one more point
+		std::size_t size	= count;
+		std::size_t smaller	= 1u;
+		std::size_t larger	= 0u;
+
+		while ((smaller + larger) > 0u)
+		{
+			returnValue += smaller + larger;
+
+			const std::size_t splitSmaller	= (size > leafSize) ? smaller : 0u;
+			const std::size_t splitLarger	= ((size + 1u) > leafSize) ? larger : 0u;
+
+			if ((size % 2u) == 0u)
+			{
+				smaller	= 2u * splitSmaller + splitLarger;
+				larger	= splitLarger;
+			}
+			else
+			{
+				smaller	= splitSmaller;
+				larger	= splitSmaller + 2u * splitLarger;
+			}
+
+			size /= 2u;
+		}
+
+		return returnValue;
+	}
+
+	static constexpr ValueType dot(const VectorType &left, const VectorType &right)
+	{
+		ValueType returnValue = {};
+
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			returnValue += left[order] * right[order];
+		}
+
+		return returnValue;
+	}
+
+	///
+	/// Returns the square distance from \a point to the closest point of \a box, zero inside.
+	///
+	static constexpr ValueType squareDistance(const BoxType &box, const VectorType &point)
+	{
+		ValueType returnValue = {};
+
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			const ValueType distance = std::max({box.minimum[order] - point[order], ValueType{}, point[order] - box.maximum[order]});
+			returnValue += distance * distance;
+		}
+
+		return returnValue;
+	}
+
+	///
+	/// Returns the ray parameter at which the ray enters \a box grown by \a radius, zero if it starts inside and infinity if it misses.
+	///
+	static constexpr ValueType entryDistance(const BoxType &box, const VectorType &origin, const VectorType &inverseDirection, const ValueType radius)
+	{
+		ValueType entry	= ValueType{};
+		ValueType exit	= std::numeric_limits<ValueType>::infinity();
+
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			const ValueType near	= (box.minimum[order] - radius - origin[order]) * inverseDirection[order];
+			const ValueType far		= (box.maximum[order] + radius - origin[order]) * inverseDirection[order];
+
+			// Written so NaNs of rays parallel to a slab boundary leave the interval unchanged
+			entry	= std::max(entry, std::min(near, far));
+			exit	= std::min(exit, std::max(near, far));
+		}
+
+		return (entry <= exit) ? entry : std::numeric_limits<ValueType>::infinity();
+	}
+
+	///
+	/// Writes the square distances from \a query to all points of the leaf \a node to \a result.
+	///
+	void leafSquareDistances(const Node &node, const VectorType &query, ValueType (&result)[leafSize]) const
+	{
+		const std::uint32_t *indices = this->_indices.data() + node.first;
+
+		std::fill_n(result, leafSize, ValueType{});
+
+		// Component-wise over all points of the leaf, so the loops vectorize with gathers
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			for (std::size_t point = 0u; point < node.count; ++point)
+			{
+				const ValueType distance = *this->_points->data(order, indices[point]) - query[order];
+				result[point] += distance * distance;
+			}
+		}
+	}
+
+	BoxType leafBounds(const std::size_t first, const std::size_t count) const
+	{
+		BoxType returnValue = BoxType::empty();
+
+		for (std::size_t index = first; index < (first + count); ++index)
+		{
+			returnValue.merge(VectorType((*this->_points)[this->_indices[index]]));
+		}
+
+		return returnValue;
+	}
+
+	///
+	/// Invokes \a function for both halves of a subtree over \a count points, in parallel for large subtrees.
+	///
+	template <typename Function>
+	static void forBothChildren(const std::size_t count, const Function &function)
+	{
+		if (count >= SpatialIndex::_parallelBuildSize)
+		{
+			ThreadPool::instance().parallelFor(2u, function);
+		}
+		else
+		{
+			function(0u);
+			function(1u);
+		}
+	}
+
+	void buildNode(const std::size_t index, const std::size_t first, const std::size_t count)
+	{
+		Node &node = this->_nodes[index];
+
+		node.bounds = this->leafBounds(first, count);
+
+		if (count <= leafSize)
+		{
+			node.first = static_cast<std::uint32_t>(first);
+			node.count = static_cast<std::uint32_t>(count);
+			return;
+		}
+
+		const VectorType	extent	= node.bounds.extent();
+		const std::size_t	axis	= std::max_element(extent.data(), extent.data() + Order) - extent.data();
+		const std::size_t	half	= count / 2u;
+		const std::size_t	right	= index + 1u + SpatialIndex::nodeCount(half);
+
+		std::uint32_t * const begin = this->_indices.data() + first;
+
+		std::nth_element(begin, begin + half, begin + count, [this, axis](const std::uint32_t left, const std::uint32_t right)
+		{
+			return *this->_points->data(axis, left) < *this->_points->data(axis, right);
+		});
+
+		node.first = static_cast<std::uint32_t>(right);
+		node.count = 0u;
+
+		SpatialIndex::forBothChildren(count, [this, index, first, count, half, right](const std::size_t child)
+		{
+			if (child == 0u)
+			{
+				this->buildNode(index + 1u, first, half);
+			}
+			else
+			{
+				this->buildNode(right, first + half, count - half);
+			}
+		});
+	}
+
+	void refitNode(const std::size_t index, const std::size_t count)
+	{
+		Node &node = this->_nodes[index];
+
+		if (node.count > 0u)
+		{
+			node.bounds = this->leafBounds(node.first, node.count);
+			return;
+		}
+
+		const std::size_t half = count / 2u;
+
+		SpatialIndex::forBothChildren(count, [this, index, count, half, &node](const std::size_t child)
+		{
+			if (child == 0u)
+			{
+				this->refitNode(index + 1u, half);
+			}
+			else
+			{
+				this->refitNode(node.first, count - half);
+			}
+		});
+
+		node.bounds = this->_nodes[index + 1u].bounds;
+		node.bounds.merge(this->_nodes[node.first].bounds);
+	}
+};
+
+} // namespace nd::math
+
+#endif // ND_MATH_SPATIAL_INDEX_HPP
@@ -0,0 +1,213 @@
+#ifndef ND_MATH_STRASSEN_HPP
+#define ND_MATH_STRASSEN_HPP
+
+#include <cassert>
+#include <cstddef>
+
+#include "dynamicmatrix.hpp"
+#include "gemm.hpp"
+#include "matrix.hpp"
+#include "memory.hpp"
+
+namespace nd::math
+{
+
+namespace detail
+{
+
+///
+/// Order below which \ref strassenWinograd hands over to the blocked kernel. Below it the saved products no longer pay for the additional
+/// passes over memory of the 15 block additions.
+///
+inline constexpr std::size_t strassenCutoff = 256u;
+
+///
+/// Returns the number of scratch elements \ref strassenWinograd needs for an $order \times order$ product: three half sized blocks on every
+/// level of the recursion.
+///
+inline constexpr std::size_t strassenArenaSize(std::size_t order, const std::size_t cutoff)
+{
+	std::size_t returnValue = 0u;
+
+	while (order > cutoff)
+	{
+		order		/= 2u;
+		returnValue	+= 3u * order * order;
+	}
+
+	return returnValue;
+}
+
+template <typename ValueType>
+inline void strassenAdd(const std::size_t order, const ValueType *left, const std::size_t leftStride, const ValueType *right,
+						const std::size_t rightStride, ValueType *result, const std::size_t resultStride)
+{
+	for (std::size_t i = 0u; i < order; ++i)
+	{
+		for (std::size_t j = 0u; j < order; ++j)
+		{
+			result[i * resultStride + j] = left[i * leftStride + j] + right[i * rightStride + j];
+		}
+	}
+}
+
+template <typename ValueType>
+inline void strassenSubtract(const std::size_t order, const ValueType *left, const std::size_t leftStride, const ValueType *right,
+							 const std::size_t rightStride, ValueType *result, const std::size_t resultStride)
+{
+	for (std::size_t i = 0u; i < order; ++i)
+	{
+		for (std::size_t j = 0u; j < order; ++j)
+		{
+			result[i * resultStride + j] = left[i * leftStride + j] - right[i * rightStride + j];
+		}
+	}
+}
+
+///
+/// Computes $C = A B$ for the square, row-major $order \times order$ matrices \a left, \a right and \a result using the Winograd variant of
+/// Strassen's algorithm: seven half sized products and fifteen block additions per level, recursing down to \a cutoff.
+///
+/// \a arena has to hold \ref strassenArenaSize elements. Odd orders are peeled: the leading even block recurses and the last row and column
+/// are added by thin products.
+///
+template <typename ValueType>
+inline void strassenWinograd(const std::size_t order, const ValueType *left, const std::size_t leftStride, const ValueType *right,
+							 const std::size_t rightStride, ValueType *result, const std::size_t resultStride, const std::size_t cutoff,
+							 ValueType *arena)
+{
+	using Blocking = GemmBlocking<ValueType>;
+
+	if (order <= cutoff)
+	{
+		gemm<Blocking>(order, order, order, ValueType{1}, GemmOperand<ValueType>{left, leftStride}, GemmOperand<ValueType>{right, rightStride},
+					   ValueType{}, result, resultStride);
+		return;
+	}
+
+	const std::size_t h = order / 2u;
+
+	const ValueType *a11 = left;
+	const ValueType *a12 = left + h;
+	const ValueType *a21 = left + h * leftStride;
+	const ValueType *a22 = left + h * leftStride + h;
+
+	const ValueType *b11 = right;
+	const ValueType *b12 = right + h;
+	const ValueType *b21 = right + h * rightStride;
+	const ValueType *b22 = right + h * rightStride + h;
+
+	ValueType *c11 = result;
+	ValueType *c12 = result + h;
+	ValueType *c21 = result + h * resultStride;
+	ValueType *c22 = result + h * resultStride + h;
+
+	ValueType *x		= arena;
+	ValueType *y		= x + h * h;
+	ValueType *z		= y + h * h;
+	ValueType *nested	= z + h * h;
+
+	// C21 = P7 = (A11 - A21)(B22 - B12)
+	strassenSubtract(h, a11, leftStride, a21, leftStride, x, h);
+	strassenSubtract(h, b22, rightStride, b12, rightStride, y, h);
+	strassenWinograd(h, x, h, y, h, c21, resultStride, cutoff, nested);
+
+	// C22 = P5 = (A21 + A22)(B12 - B11)
+	strassenAdd(h, a21, leftStride, a22, leftStride, x, h);
+	strassenSubtract(h, b12, rightStride, b11, rightStride, y, h);
+	strassenWinograd(h, x, h, y, h, c22, resultStride, cutoff, nested);
+
+	// C12 = P6 = (A21 + A22 - A11)(B22 - B12 + B11)
+	strassenSubtract(h, x, h, a11, leftStride, x, h);
+	strassenSubtract(h, b22, rightStride, y, h, y, h);
+	strassenWinograd(h, x, h, y, h, c12, resultStride, cutoff, nested);
+
+	// Z = P1 = A11 B11
+	strassenWinograd(h, a11, leftStride, b11, rightStride, z, h, cutoff, nested);
+
+	// C12 = U2 = P1 + P6, C21 = U3 = U2 + P7, C12 = U4 = U2 + P5, C22 = U7 = U3 + P5
+	strassenAdd(h, c12, resultStride, z, h, c12, resultStride);
+	strassenAdd(h, c21, resultStride, c12, resultStride, c21, resultStride);
+	strassenAdd(h, c12, resultStride, c22, resultStride, c12, resultStride);
+	strassenAdd(h, c22, resultStride, c21, resultStride, c22, resultStride);
+
+	// C12 = U5 = U4 + P3 with P3 = (A12 - S2) B22
+	strassenSubtract(h, a12, leftStride, x, h, x, h);
+	strassenWinograd(h, x, h, b22, rightStride, c11, resultStride, cutoff, nested);
+	strassenAdd(h, c12, resultStride, c11, resultStride, c12, resultStride);
+
+	// C21 = U6 = U3 - P4 with P4 = A22 (T2 - B21)
+	strassenSubtract(h, y, h, b21, rightStride, y, h);
+	strassenWinograd(h, a22, leftStride, y, h, c11, resultStride, cutoff, nested);
+	strassenSubtract(h, c21, resultStride, c11, resultStride, c21, resultStride);
+
+	// C11 = U1 = P1 + P2 with P2 = A12 B21
+	strassenWinograd(h, a12, leftStride, b21, rightStride, c11, resultStride, cutoff, nested);
+	strassenAdd(h, c11, resultStride, z, h, c11, resultStride);
+
+	if ((order % 2u) != 0u)
+	{
+		const std::size_t m = order - 1u;
+
+		const GemmOperand<ValueType> leftOperand{left, leftStride};
+		const GemmOperand<ValueType> rightOperand{right, rightStride};
+
+		// Leading block: add the outer product of the last column of A and the last row of B
+		gemmReference(m, m, 1u, ValueType{1}, leftOperand.offset(0u, m), rightOperand.offset(m, 0u), ValueType{1}, result, resultStride);
+
+		// Last column and last row of C
+		gemmReference(m, 1u, order, ValueType{1}, leftOperand, rightOperand.offset(0u, m), ValueType{}, result + m, resultStride);
+		gemmReference(1u, order, order, ValueType{1}, leftOperand.offset(m, 0u), rightOperand, ValueType{}, result + m * resultStride, resultStride);
+	}
+}
+
+} // namespace detail
+
+///
+/// Computes the product of the square views \a left and \a right into \a result, which must not alias either operand, using the
+/// Strassen-Winograd algorithm down to order \a cutoff and the blocked kernel below.
+///
+/// Every level of the recursion replaces one eighth of the multiplications by fifteen block additions, so it only pays off for large
+/// orders; the default cutoff recurses once for 512x512 products. The scratch memory is a thread local arena reused across calls.
+///
+/// \warning Strassen-type algorithms are only stable in a norm-wise sense. Following Higham, Accuracy and Stability of Numerical Algorithms,
+/// chapter 23, the computed product satisfies
+/// \f[ \|C - \hat C\| \le \left[\left(\frac{n}{n_0}\right)^{\log_2 18} (n_0^2 + 6 n_0) - 6 n\right] u \|A\| \|B\| + O(u^2) \f]
+/// in the max norm, with $n_0$ the cutoff and $u$ the unit roundoff, compared to $n u |A| |B|$ element-wise for the conventional product.
+/// Errors therefore scale with the largest elements of the operands: entries of the result that are small compared to $\|A\| \|B\|$ may lose
+/// all relative accuracy. Only enable it where operands are well scaled, and prefer a larger \a cutoff, which tightens the bound.
+///
+template <typename ValueType>
+void mulStrassen(const MatrixView<ValueType> result, const MatrixView<const std::type_identity_t<ValueType>> left,
+				 const MatrixView<const std::type_identity_t<ValueType>> right, const std::size_t cutoff = detail::strassenCutoff)
+{
+	static_assert(detail::GemmBlocking<ValueType>::supported, "Strassen-Winograd requires elements supported by the blocked kernel");
+
+	const std::size_t order = left.rows();
+
+	assert((left.columns() == order) & (right.rows() == order) & (right.columns() == order));
+	assert((result.rows() == order) & (result.columns() == order));
+	assert(cutoff > 0u);
+
+	ValueType *arena = memory::scratch<ValueType, 2u>(detail::strassenArenaSize(order, cutoff));
+
+	detail::strassenWinograd(order, left.data(), left.stride(), right.data(), right.stride(), result.data(), result.stride(), cutoff, arena);
+}
+
+template <typename ValueType, std::size_t Order>
+void mulStrassen(Matrix<ValueType, Order, Order> &result, const Matrix<ValueType, Order, Order> &left, const Matrix<ValueType, Order, Order> &right,
+				 const std::size_t cutoff = detail::strassenCutoff)
+{
+	mulStrassen(view(result), view(left), view(right), cutoff);
+}
+
+template <typename ValueType>
+void mulStrassen(DynamicMatrix<ValueType> &result, const DynamicMatrix<ValueType> &left, const DynamicMatrix<ValueType> &right,
+				 const std::size_t cutoff = detail::strassenCutoff)
+{
+	mulStrassen(result.view(), left.view(), right.view(), cutoff);
+}
+
+} // namespace nd::math
+
+#endif // ND_MATH_STRASSEN_HPP
@@ -0,0 +1,274 @@
+#ifndef ND_MATH_THREADPOOL_HPP
+#define ND_MATH_THREADPOOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nd::math
+{
+
+///
+/// Work-stealing thread pool used by the parallel algorithms of ndmath.
+///
+/// Every worker owns a task queue. A worker takes tasks from the back of its own queue and, once it runs dry, steals from the front of the
+/// queues of the other workers. Threads waiting for a batch of tasks to finish help executing tasks, so nested parallel calls do not deadlock.
+///
+class ThreadPool
+{
+public:
+	///
+	/// Creates a pool with \a workerCount worker threads. The thread calling \ref parallelFor participates as well, so a pool without workers
+	///	simply runs everything on the calling thread.
+	///
+	explicit ThreadPool(const std::size_t workerCount) :
+		_queues(workerCount)
+	{
+		for (std::unique_ptr<Queue> &queue : this->_queues)
+		{
+			queue = std::make_unique<Queue>();
+		}
+
+		this->_workers.reserve(workerCount);
+
+		for (std::size_t index = 0u; index < workerCount; ++index)
+		{
+			this->_workers.emplace_back([this, index]()
+			{
+				this->work(index);
+			});
+		}
+	}
+
+	ThreadPool(const ThreadPool &other) = delete;
+
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock{this->_mutex};
+			this->_stop = true;
+		}
+
+		this->_condition.notify_all();
+
+		for (std::thread &worker : this->_workers)
+		{
+			worker.join();
+		}
+	}
+
+	ThreadPool &operator=(const ThreadPool &other) = delete;
+
+	///
+	/// Returns the process wide pool with one worker per hardware thread besides the calling one.
+	///
+	static ThreadPool &instance()
+	{
+		static ThreadPool pool{std::max(std::thread::hardware_concurrency(), 1u) - 1u};
+		return pool;
+	}
+
+	///
+	/// Returns the number of threads executing tasks, including the calling thread.
+	///
+	std::size_t concurrency() const
+	{
+		return this->_workers.size() + 1u;
+	}
+
+	///
+	/// Invokes \a function for every index in $[0, count)$ and returns once all invocations have finished. If invocations throw, the first
+	/// exception is rethrown on the calling thread after all of them have finished.
+	///
+	template <typename Function>
+	void parallelFor(const std::size_t count, const Function &function)
+	{
+		if ((count <= 1u) | this->_workers.empty())
+		{
+			for (std::size_t index = 0u; index < count; ++index)
+			{
+				function(index);
+			}
+
+			return;
+		}
+
+		Batch batch;
+		batch.invoke	= [](const void *function, const std::size_t index)
+		{
+			(*static_cast<const Function *>(function))(index);
+		};
+		batch.function	= &function;
+		batch.remaining	= count;
+
+		// Announce the tasks first so workers never observe more taken than pending tasks
+		{
+			std::lock_guard<std::mutex> lock{this->_mutex};
+			this->_pending += count;
+		}
+
+		const std::size_t queueCount = this->_queues.size();
+
+		for (std::size_t queueIndex = 0u; queueIndex < queueCount; ++queueIndex)
+		{
+			Queue &queue = *this->_queues[queueIndex];
+			std::lock_guard<std::mutex> lock{queue.mutex};
+
+			for (std::size_t index = queueIndex; index < count; index += queueCount)
+			{
+				queue.tasks.push_back(Task{&batch, index});
+			}
+		}
+
+		this->_condition.notify_all();
+
+		while (batch.remaining.load(std::memory_order_acquire) != 0u)
+		{
+			if (!this->runTask(ThreadPool::_callerIndex))
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		if (batch.exception)
+		{
+			std::rethrow_exception(batch.exception);
+		}
+	}
+
+private:
+	struct Batch
+	{
+		void						(*invoke)(const void *, const std::size_t)	= nullptr;
+		const void					*function									= nullptr;
+		std::atomic<std::size_t>	remaining									= 0u;
+		std::mutex					mutex;
+		std::exception_ptr			exception;
+	};
+
+	struct Task
+	{
+		Batch		*batch	= nullptr;
+		std::size_t	index	= 0u;
+	};
+
+	struct Queue
+	{
+		std::mutex			mutex;
+		std::deque<Task>	tasks;
+	};
+
+	static constexpr std::size_t _callerIndex = static_cast<std::size_t>(-1);
+
+	std::vector<std::unique_ptr<Queue>>	_queues;
+	std::vector<std::thread>			_workers;
+	std::mutex							_mutex;
+	std::condition_variable				_condition;
+	std::size_t							_pending	= 0u;
+	bool								_stop		= false;
+
+	bool takeOwn(const std::size_t queueIndex, Task &task)
+	{
+		Queue &queue = *this->_queues[queueIndex];
+		std::lock_guard<std::mutex> lock{queue.mutex};
+
+		if (queue.tasks.empty())
+		{
+			return false;
+		}
+
+		task = queue.tasks.back();
+		queue.tasks.pop_back();
+		return true;
+	}
+
+	bool steal(const std::size_t thiefIndex, Task &task)
+	{
+		const std::size_t queueCount = this->_queues.size();
+
+		for (std::size_t offset = 1u; offset <= queueCount; ++offset)
+		{
+			const std::size_t	victimIndex	= (thiefIndex + offset) % queueCount;
+			Queue				&queue		= *this->_queues[victimIndex];
+			std::lock_guard<std::mutex> lock{queue.mutex};
+
+			if (!queue.tasks.empty())
+			{
+				task = queue.tasks.front();
+				queue.tasks.pop_front();
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool runTask(const std::size_t queueIndex)
+	{
+		Task task;
+
+		const bool found = ((queueIndex != ThreadPool::_callerIndex) && this->takeOwn(queueIndex, task)) ||
+						   this->steal((queueIndex == ThreadPool::_callerIndex) ? 0u : queueIndex, task);
+
+		if (!found)
+		{
+			return false;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock{this->_mutex};
+			this->_pending--;
+		}
+
+		try
+		{
+			task.batch->invoke(task.batch->function, task.index);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock{task.batch->mutex};
+
+			if (!task.batch->exception)
+			{
+				task.batch->exception = std::current_exception();
+			}
+		}
+
+		task.batch->remaining.fetch_sub(1u, std::memory_order_acq_rel);
+
+		return true;
+	}
+
+	void work(const std::size_t queueIndex)
+	{
+		while (true)
+		{
+			if (this->runTask(queueIndex))
+			{
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock{this->_mutex};
+			this->_condition.wait(lock, [this]()
+			{
+				return this->_stop || (this->_pending != 0u);
+			});
+
+			if (this->_stop)
+			{
+				return;
+			}
+		}
+	}
+};
+
+} // namespace nd::math
+
+#endif // ND_MATH_THREADPOOL_HPP
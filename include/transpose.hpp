@@ -0,0 +1,248 @@
+#ifndef ND_MATH_TRANSPOSE_HPP
+#define ND_MATH_TRANSPOSE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "simd.hpp"
+
+namespace nd::math::detail
+{
+
+///
+/// Order of the square tiles transposed in registers: 8x8 floats and 4x4 doubles with AVX, 4x4 floats and 2x2 doubles with SSE. Other element
+/// types use 4x4 tiles transposed by scalar code.
+///
+template <typename ValueType>
+inline constexpr std::size_t transposeTile =
+#if defined(ND_MATH_SIMD_AVX)
+	std::is_same_v<ValueType, float> ? 8u : 4u;
+#elif defined(ND_MATH_SIMD_SSE)
+	std::is_same_v<ValueType, float> ? 4u : (std::is_same_v<ValueType, double> ? 2u : 4u);
+#else
+	4u;
+#endif
+
+///
+/// Blocks of at most this many rows and columns are transposed tile by tile; both fit into the L1 cache together.
+///
+template <typename ValueType>
+inline constexpr std::size_t transposeLeaf = std::max<std::size_t>(transposeTile<ValueType>, 32u);
+
+///
+/// Transposes the \ref transposeTile square tile at \a source into \a destination.
+///
+template <typename ValueType>
+inline void transposeTileKernel(const ValueType *source, const std::size_t sourceStride, ValueType *destination, const std::size_t destinationStride)
+{
+	constexpr std::size_t tile = transposeTile<ValueType>;
+
+#if defined(ND_MATH_SIMD_AVX)
+	if constexpr (std::is_same_v<ValueType, float>)
+	{
+		const __m256 r0 = _mm256_loadu_ps(source);
+		const __m256 r1 = _mm256_loadu_ps(source + sourceStride);
+		const __m256 r2 = _mm256_loadu_ps(source + 2u * sourceStride);
+		const __m256 r3 = _mm256_loadu_ps(source + 3u * sourceStride);
+		const __m256 r4 = _mm256_loadu_ps(source + 4u * sourceStride);
+		const __m256 r5 = _mm256_loadu_ps(source + 5u * sourceStride);
+		const __m256 r6 = _mm256_loadu_ps(source + 6u * sourceStride);
+		const __m256 r7 = _mm256_loadu_ps(source + 7u * sourceStride);
+
+		// Interleave pairs of rows, then quadruples, then swap the 128 bit halves
+		const __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+		const __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+		const __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+		const __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+		const __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+		const __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+		const __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+		const __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+
+		const __m256 u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+		const __m256 u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+		const __m256 u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+		const __m256 u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+		const __m256 u4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+		const __m256 u5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+		const __m256 u6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+		const __m256 u7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+		_mm256_storeu_ps(destination, _mm256_permute2f128_ps(u0, u4, 0x20));
+		_mm256_storeu_ps(destination + destinationStride, _mm256_permute2f128_ps(u1, u5, 0x20));
+		_mm256_storeu_ps(destination + 2u * destinationStride, _mm256_permute2f128_ps(u2, u6, 0x20));
+		_mm256_storeu_ps(destination + 3u * destinationStride, _mm256_permute2f128_ps(u3, u7, 0x20));
+		_mm256_storeu_ps(destination + 4u * destinationStride, _mm256_permute2f128_ps(u0, u4, 0x31));
+		_mm256_storeu_ps(destination + 5u * destinationStride, _mm256_permute2f128_ps(u1, u5, 0x31));
+		_mm256_storeu_ps(destination + 6u * destinationStride, _mm256_permute2f128_ps(u2, u6, 0x31));
+		_mm256_storeu_ps(destination + 7u * destinationStride, _mm256_permute2f128_ps(u3, u7, 0x31));
+		return;
+	}
+	else if constexpr (std::is_same_v<ValueType, double>)
+	{
+		const __m256d r0 = _mm256_loadu_pd(source);
+		const __m256d r1 = _mm256_loadu_pd(source + sourceStride);
+		const __m256d r2 = _mm256_loadu_pd(source + 2u * sourceStride);
+		const __m256d r3 = _mm256_loadu_pd(source + 3u * sourceStride);
+
+		const __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+		const __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+		const __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+		const __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+
+		_mm256_storeu_pd(destination, _mm256_permute2f128_pd(t0, t2, 0x20));
+		_mm256_storeu_pd(destination + destinationStride, _mm256_permute2f128_pd(t1, t3, 0x20));
+		_mm256_storeu_pd(destination + 2u * destinationStride, _mm256_permute2f128_pd(t0, t2, 0x31));
+		_mm256_storeu_pd(destination + 3u * destinationStride, _mm256_permute2f128_pd(t1, t3, 0x31));
+		return;
+	}
+#elif defined(ND_MATH_SIMD_SSE)
+	if constexpr (std::is_same_v<ValueType, float>)
+	{
+		__m128 r0 = _mm_loadu_ps(source);
+		__m128 r1 = _mm_loadu_ps(source + sourceStride);
+		__m128 r2 = _mm_loadu_ps(source + 2u * sourceStride);
+		__m128 r3 = _mm_loadu_ps(source + 3u * sourceStride);
+
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+		_mm_storeu_ps(destination, r0);
+		_mm_storeu_ps(destination + destinationStride, r1);
+		_mm_storeu_ps(destination + 2u * destinationStride, r2);
+		_mm_storeu_ps(destination + 3u * destinationStride, r3);
+		return;
+	}
+	else if constexpr (std::is_same_v<ValueType, double>)
+	{
+		const __m128d r0 = _mm_loadu_pd(source);
+		const __m128d r1 = _mm_loadu_pd(source + sourceStride);
+
+		_mm_storeu_pd(destination, _mm_unpacklo_pd(r0, r1));
+		_mm_storeu_pd(destination + destinationStride, _mm_unpackhi_pd(r0, r1));
+		return;
+	}
+#endif
+
+	for (std::size_t i = 0u; i < tile; ++i)
+	{
+		for (std::size_t j = 0u; j < tile; ++j)
+		{
+			destination[j * destinationStride + i] = source[i * sourceStride + j];
+		}
+	}
+}
+
+///
+/// Writes the transpose of the $rows \times columns$ block at \a source to \a destination.
+///
+/// The block is halved along its longer side until it fits into the L1 cache, so every level of the memory hierarchy is used without knowing
+/// its size. Leaves are transposed in register tiles, the remaining edge elements one by one.
+///
+template <typename ValueType>
+inline void transpose(const ValueType *source, const std::size_t sourceStride, ValueType *destination, const std::size_t destinationStride,
+					  const std::size_t rows, const std::size_t columns)
+{
+	constexpr std::size_t tile = transposeTile<ValueType>;
+	constexpr std::size_t leaf = transposeLeaf<ValueType>;
+
+	if ((rows > leaf) | (columns > leaf))
+	{
+		if (rows >= columns)
+		{
+			const std::size_t half = ((rows / 2u + tile - 1u) / tile) * tile;
+
+			transpose(source, sourceStride, destination, destinationStride, half, columns);
+			transpose(source + half * sourceStride, sourceStride, destination + half, destinationStride, rows - half, columns);
+		}
+		else
+		{
+			const std::size_t half = ((columns / 2u + tile - 1u) / tile) * tile;
+
+			transpose(source, sourceStride, destination, destinationStride, rows, half);
+			transpose(source + half, sourceStride, destination + half * destinationStride, destinationStride, rows, columns - half);
+		}
+
+		return;
+	}
+
+	const std::size_t tiledRows		= (rows / tile) * tile;
+	const std::size_t tiledColumns	= (columns / tile) * tile;
+
+	for (std::size_t i = 0u; i < tiledRows; i += tile)
+	{
+		for (std::size_t j = 0u; j < tiledColumns; j += tile)
+		{
+			transposeTileKernel(source + i * sourceStride + j, sourceStride, destination + j * destinationStride + i, destinationStride);
+		}
+	}
+
+	for (std::size_t i = 0u; i < rows; ++i)
+	{
+		for (std::size_t j = (i < tiledRows) ? tiledColumns : 0u; j < columns; ++j)
+		{
+			destination[j * destinationStride + i] = source[i * sourceStride + j];
+		}
+	}
+}
+
+///
+/// Transposes the square $order \times order$ matrix at \a data in place.
+///
+/// Pairs of tiles mirrored at the diagonal are transposed in registers and exchanged through a buffer of a single tile, iterating over
+/// L1 sized blocks so both tiles of a pair stay cached.
+///
+template <typename ValueType>
+inline void transposeInPlace(ValueType *data, const std::size_t stride, const std::size_t order)
+{
+	constexpr std::size_t tile = transposeTile<ValueType>;
+	constexpr std::size_t leaf = transposeLeaf<ValueType>;
+
+	const std::size_t tiledOrder = (order / tile) * tile;
+
+	ValueType buffer[tile * tile];
+
+	for (std::size_t blockRow = 0u; blockRow < tiledOrder; blockRow += leaf)
+	{
+		for (std::size_t blockColumn = blockRow; blockColumn < tiledOrder; blockColumn += leaf)
+		{
+			const std::size_t rowEnd	= std::min(blockRow + leaf, tiledOrder);
+			const std::size_t columnEnd	= std::min(blockColumn + leaf, tiledOrder);
+
+			for (std::size_t i = blockRow; i < rowEnd; i += tile)
+			{
+				for (std::size_t j = std::max(i, blockColumn); j < columnEnd; j += tile)
+				{
+					ValueType * const upper = data + i * stride + j;
+					ValueType * const lower = data + j * stride + i;
+
+					// Diagonal tiles are their own mirror image
+					transposeTileKernel(upper, stride, buffer, tile);
+
+					if (i != j)
+					{
+						transposeTileKernel(lower, stride, upper, stride);
+					}
+
+					for (std::size_t row = 0u; row < tile; ++row)
+					{
+						std::copy_n(buffer + row * tile, tile, lower + row * stride);
+					}
+				}
+			}
+		}
+	}
+
+	for (std::size_t i = 0u; i < order; ++i)
+	{
+		for (std::size_t j = std::max(i + 1u, tiledOrder); j < order; ++j)
+		{
+			std::swap(data[i * stride + j], data[j * stride + i]);
+		}
+	}
+}
+
+} // namespace nd::math::detail
+
+#endif // ND_MATH_TRANSPOSE_HPP
@@ -1,58 +1,1822 @@
 #ifndef ND_MATH_VECTOR_SOA_HPP
 #define ND_MATH_VECTOR_SOA_HPP
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "boundingbox.hpp"
+#include "common.hpp"
+#include "layout.hpp"
 #include "matrix.hpp"
+#include "memory.hpp"
+#include "simd.hpp"
+#include "threadpool.hpp"
 
 namespace nd::math
 {
 
+namespace detail
+{
+
+#if defined(__GNUC__)
+template <typename ValueType, std::size_t Lanes>
+using BatchRegister __attribute__ ((vector_size (Lanes * sizeof (ValueType)))) = ValueType;
+#endif
+
+template <typename Lane, typename ValueType>
+inline Lane batchLoad(const ValueType *source)
+{
+	if constexpr (std::is_same_v<Lane, ValueType>)
+	{
+		return *source;
+	}
+	else
+	{
+		Lane returnValue;
+		std::memcpy(&returnValue, source, sizeof (Lane));
+		return returnValue;
+	}
+}
+
+template <typename Lane, typename ValueType>
+inline void batchStore(ValueType *destination, const Lane &value)
+{
+	if constexpr (std::is_same_v<Lane, ValueType>)
+	{
+		*destination = value;
+	}
+	else
+	{
+		std::memcpy(destination, &value, sizeof (Lane));
+	}
+}
+
+///
+/// Returns the square root of every lane of \a value, which is either a \a ValueType or a vector register of them.
+///
+template <typename ValueType, typename Lane>
+inline Lane batchSquareRoot(const Lane value)
+{
+	using std::sqrt;
+
+	if constexpr (std::is_same_v<Lane, ValueType>)
+	{
+		return sqrt(value);
+	}
+	else
+	{
+		constexpr bool isFloat	= std::is_same_v<ValueType, float>;
+		constexpr bool isDouble	= std::is_same_v<ValueType, double>;
+
+#if defined(ND_MATH_SIMD_AVX512)
+		// The zero masking forms with all lanes set avoid the undefined source operand of the unmasked ones, which GCC flags as uninitialized
+		if constexpr (isFloat & (sizeof (Lane) == 64u))
+		{
+			return _mm512_maskz_sqrt_ps(__mmask16(0xFFFFu), value);
+		}
+		else if constexpr (isDouble & (sizeof (Lane) == 64u))
+		{
+			return _mm512_maskz_sqrt_pd(__mmask8(0xFFu), value);
+		}
+#endif
+#if defined(ND_MATH_SIMD_AVX)
+		if constexpr (isFloat & (sizeof (Lane) == 32u))
+		{
+			return _mm256_sqrt_ps(value);
+		}
+		else if constexpr (isDouble & (sizeof (Lane) == 32u))
+		{
+			return _mm256_sqrt_pd(value);
+		}
+#endif
+#if defined(ND_MATH_SIMD_SSE)
+		if constexpr (isFloat & (sizeof (Lane) == 16u))
+		{
+			return _mm_sqrt_ps(value);
+		}
+		else if constexpr (isDouble & (sizeof (Lane) == 16u))
+		{
+			return _mm_sqrt_pd(value);
+		}
+#endif
+
+		Lane returnValue = value;
+
+		for (std::size_t lane = 0u; lane < (sizeof (Lane) / sizeof (ValueType)); ++lane)
+		{
+			returnValue[lane] = sqrt(returnValue[lane]);
+		}
+
+		return returnValue;
+	}
+}
+
+///
+/// Returns the elements of \a source at \a Stride times the \a indices, one per lane of \a Lane, which is either a \a ValueType or a vector
+/// register of them, using the gather instructions for 32 bit indices where available and building the register element by element
+/// otherwise.
+///
+template <std::size_t Stride, typename Lane, typename ValueType, typename Index>
+inline Lane batchGather(const ValueType *source, const Index *indices)
+{
+	static_assert(std::is_integral_v<Index>, "Invalid indices");
+
+	if constexpr (std::is_same_v<Lane, ValueType>)
+	{
+		return source[std::size_t(*indices) * Stride];
+	}
+	else
+	{
+#if defined(ND_MATH_SIMD_AVX2)
+		constexpr bool isFloat		= std::is_same_v<ValueType, float>;
+		constexpr bool isDouble		= std::is_same_v<ValueType, double>;
+		constexpr bool isIndex32	= (sizeof (Index) == 4u);
+
+		// The masked forms with all lanes set avoid the undefined source operand of the unmasked ones like in batchSquareRoot
+#if defined(ND_MATH_SIMD_AVX512)
+		if constexpr (isFloat & isIndex32 & (sizeof (Lane) == 64u))
+		{
+			const __m512i offsets = _mm512_mullo_epi32(_mm512_loadu_si512(indices), _mm512_set1_epi32(int(Stride)));
+			return _mm512_mask_i32gather_ps(_mm512_setzero_ps(), __mmask16(0xFFFFu), offsets, source, sizeof (ValueType));
+		}
+		else if constexpr (isDouble & isIndex32 & (sizeof (Lane) == 64u))
+		{
+			const __m256i offsets = _mm256_mullo_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(indices)), _mm256_set1_epi32(int(Stride)));
+			return _mm512_mask_i32gather_pd(_mm512_setzero_pd(), __mmask8(0xFFu), offsets, source, sizeof (ValueType));
+		}
+#endif
+		if constexpr (isFloat & isIndex32 & (sizeof (Lane) == 32u))
+		{
+			const __m256i offsets = _mm256_mullo_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(indices)), _mm256_set1_epi32(int(Stride)));
+			return _mm256_mask_i32gather_ps(_mm256_setzero_ps(), source, offsets, _mm256_castsi256_ps(_mm256_set1_epi32(-1)), sizeof (ValueType));
+		}
+		else if constexpr (isDouble & isIndex32 & (sizeof (Lane) == 32u))
+		{
+			const __m128i offsets = _mm_mullo_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(indices)), _mm_set1_epi32(int(Stride)));
+			return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), source, offsets, _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), sizeof (ValueType));
+		}
+#endif
+
+		Lane returnValue;
+
+		for (std::size_t lane = 0u; lane < (sizeof (Lane) / sizeof (ValueType)); ++lane)
+		{
+			returnValue[lane] = source[std::size_t(indices[lane]) * Stride];
+		}
+
+		return returnValue;
+	}
+}
+
+///
+/// Calls \a kernel with the index of every full vector register of \a Lanes elements out of \a size and a register typed lane tag, then
+/// once per remaining element with a \a ValueType tag. Kernels load, compute and store through \ref batchLoad and \ref batchStore for either
+/// lane type, so the same code handles the vectorized body and the scalar tail. The first \a head elements are processed one by one as well,
+/// see \ref batchHead.
+///
+template <typename ValueType, std::size_t Lanes, typename Kernel>
+inline void batch(const std::size_t head, const std::size_t size, const Kernel &kernel)
+{
+	assert(head <= size);
+
+	std::size_t index = 0u;
+
+	for (; index < head; ++index)
+	{
+		kernel(index, ValueType{});
+	}
+
+#if defined(__GNUC__)
+	if constexpr ((Lanes > 1u) & std::is_arithmetic_v<ValueType>)
+	{
+		for (; (index + Lanes) <= size; index += Lanes)
+		{
+			kernel(index, BatchRegister<ValueType, Lanes>{});
+		}
+	}
+#endif
+
+	for (; index < size; ++index)
+	{
+		kernel(index, ValueType{});
+	}
+}
+
+///
+/// Returns the number of leading vectors \ref batch has to process one by one for views of \a size vectors starting at \a offset and
+/// \a offsets, so no register straddles two blocks of a non-contiguous \a Mapping. Views that start at different lanes of their blocks can
+/// not share registers at all.
+///
+template <typename Mapping, typename... Offsets>
+inline constexpr std::size_t batchHead(const std::size_t size, const std::size_t offset, const Offsets... offsets)
+{
+	if constexpr (Mapping::contiguous)
+	{
+		return 0u;
+	}
+	else
+	{
+		if ((((offsets % Mapping::lanes) != (offset % Mapping::lanes)) | ... | false))
+		{
+			return size;
+		}
+
+		return std::min(size, (Mapping::lanes - offset % Mapping::lanes) % Mapping::lanes);
+	}
+}
+
+#if defined(ND_MATH_VECTOR_SHUFFLE)
+///
+/// Returns the index selecting lane \a lane of output register \a output in step \a step of \ref interleaveShuffle.
+///
+/// Interleaving turns \a Count component registers into \a Count registers of consecutive vectors, deinterleaving does the opposite. Each
+/// output lane comes from one lane of one input register; step $s$ combines the partial result with input register $s$, so lanes from later
+/// inputs are don't-care until their step. The first step starts from input register 0.
+///
+template <std::size_t Lanes, std::size_t Count, bool Interleave>
+inline constexpr int interleaveIndex(const std::size_t output, const std::size_t lane, const std::size_t step)
+{
+	const std::size_t position	= Interleave ? (output * Lanes + lane) : (lane * Count + output);
+	const std::size_t input		= Interleave ? (position % Count) : (position / Lanes);
+	const std::size_t inputLane	= Interleave ? (position / Count) : (position % Lanes);
+
+	if (input == step)
+	{
+		return int(Lanes + inputLane);
+	}
+
+	return ((step == 1u) & (input == 0u)) ? int(inputLane) : int(lane);
+}
+
+template <std::size_t Lanes, std::size_t Count, bool Interleave, std::size_t Output, std::size_t Step, typename Register, std::size_t... Lane>
+inline Register interleaveStep(const Register partial, const Register input, std::index_sequence<Lane...>)
+{
+	return __builtin_shufflevector(partial, input, interleaveIndex<Lanes, Count, Interleave>(Output, Lane, Step)...);
+}
+
+template <std::size_t Lanes, std::size_t Count, bool Interleave, std::size_t Output, typename Register, std::size_t... Step>
+inline Register interleaveShuffle(const Register (&inputs)[Count], std::index_sequence<Step...>)
+{
+	Register returnValue = inputs[0u];
+	((returnValue = interleaveStep<Lanes, Count, Interleave, Output, Step + 1u>(returnValue, inputs[Step + 1u], std::make_index_sequence<Lanes>{})),
+	 ...);
+	return returnValue;
+}
+
+///
+/// Transposes \a Count registers of \a Lanes elements between interleaved and component order. Each output takes $Count - 1$ two-source
+/// shuffles, a single \c vpermt2ps or \c vpermt2pd each with AVX-512.
+///
+template <std::size_t Lanes, std::size_t Count, bool Interleave, typename Register, std::size_t... Output>
+inline void interleaveRegisters(const Register (&inputs)[Count], Register (&outputs)[Count], std::index_sequence<Output...>)
+{
+	((outputs[Output] = interleaveShuffle<Lanes, Count, Interleave, Output>(inputs, std::make_index_sequence<Count - 1u>{})), ...);
+}
+#endif
+
+///
+/// Copies \a count vectors of \a Order interleaved components at \a source into the component arrays \a destinations, a register of
+/// \a Lanes vectors at a time for two to four components.
+///
+template <std::size_t Order, std::size_t Lanes, typename ValueType>
+inline void deinterleave(const ValueType *source, const std::size_t count, ValueType * const *destinations)
+{
+	std::size_t index = 0u;
+
+#if defined(ND_MATH_VECTOR_SHUFFLE)
+	if constexpr (std::is_arithmetic_v<ValueType> & (Order >= 2u) & (Order <= 4u) & (Lanes > 1u))
+	{
+		using Register = BatchRegister<ValueType, Lanes>;
+
+		for (; (index + Lanes) <= count; index += Lanes)
+		{
+			Register vectors[Order];
+			Register components[Order];
+
+			for (std::size_t order = 0u; order < Order; ++order)
+			{
+				vectors[order] = batchLoad<Register>(source + index * Order + order * Lanes);
+			}
+
+			interleaveRegisters<Lanes, Order, false>(vectors, components, std::make_index_sequence<Order>{});
+
+			for (std::size_t order = 0u; order < Order; ++order)
+			{
+				batchStore(destinations[order] + index, components[order]);
+			}
+		}
+	}
+#endif
+
+	for (; index < count; ++index)
+	{
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			destinations[order][index] = source[index * Order + order];
+		}
+	}
+}
+
+///
+/// Copies \a count vectors from the component arrays \a sources to \a destination, interleaving their \a Order components.
+///
+template <std::size_t Order, std::size_t Lanes, typename ValueType>
+inline void interleave(const ValueType * const *sources, const std::size_t count, ValueType *destination)
+{
+	std::size_t index = 0u;
+
+#if defined(ND_MATH_VECTOR_SHUFFLE)
+	if constexpr (std::is_arithmetic_v<ValueType> & (Order >= 2u) & (Order <= 4u) & (Lanes > 1u))
+	{
+		using Register = BatchRegister<ValueType, Lanes>;
+
+		for (; (index + Lanes) <= count; index += Lanes)
+		{
+			Register components[Order];
+			Register vectors[Order];
+
+			for (std::size_t order = 0u; order < Order; ++order)
+			{
+				components[order] = batchLoad<Register>(sources[order] + index);
+			}
+
+			interleaveRegisters<Lanes, Order, true>(components, vectors, std::make_index_sequence<Order>{});
+
+			for (std::size_t order = 0u; order < Order; ++order)
+			{
+				batchStore(destination + index * Order + order * Lanes, vectors[order]);
+			}
+		}
+	}
+#endif
+
+	for (; index < count; ++index)
+	{
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			destination[index * Order + order] = sources[order][index];
+		}
+	}
+}
+
+///
+/// Whether \a Range is a contiguous range of row or column vectors with \a Order elements of \a ValueType, whose components are therefore
+/// interleaved in memory.
+///
+template <typename Range, typename ValueType, std::size_t Order>
+inline constexpr bool isInterleavedRange()
+{
+	if constexpr (std::ranges::contiguous_range<Range>)
+	{
+		using Vector = std::ranges::range_value_t<Range>;
+		return (std::is_same_v<Vector, Matrix<ValueType, 1u, Order>> || std::is_same_v<Vector, Matrix<ValueType, Order, 1u>>);
+	}
+	else
+	{
+		return false;
+	}
+}
+
+} // namespace detail
+
+///
+/// Reference to a vector stored in a \ref VectorSoA.
+///
+/// Components are accessed where they are stored, so updating a single component neither gathers nor scatters the others. The reference is a
+/// handle like a pointer: it is const-qualified independently of the referenced vector, whose constness follows \a ValueType. Assignments
+/// always copy components, they never rebind the reference.
+///
 template <typename ValueType, std::size_t Order>
-class VectorSoA
+class VectorSoAReference
 {
 public:
-	using VectorType = ColumnVector<ValueType, Order>;
+	using value_type = std::remove_const_t<ValueType>;
+	using VectorType = ColumnVector<value_type, Order>;
+
+	constexpr VectorSoAReference(ValueType *data, const std::size_t stride) :
+		_data(data),
+		_stride(stride)
+	{
+	}
+
+	template <typename Unused_ = void, typename = std::enable_if_t<std::is_const_v<ValueType>, Unused_>>
+	constexpr VectorSoAReference(const VectorSoAReference<value_type, Order> &other) :
+		VectorSoAReference(other.data(), other.stride())
+	{
+	}
+
+	constexpr VectorSoAReference(const VectorSoAReference &other) = default;
 
-	constexpr VectorType operator[](const std::size_t index) const
+	constexpr const VectorSoAReference &operator=(const VectorSoAReference &other) const
+	{
+		return (*this = static_cast<VectorType>(other));
+	}
+
+	template <typename Other, typename = std::enable_if_t<std::is_same_v<std::remove_const_t<Other>, value_type>>>
+	constexpr const VectorSoAReference &operator=(const VectorSoAReference<Other, Order> &other) const
+	{
+		return (*this = static_cast<VectorType>(other));
+	}
+
+	constexpr const VectorSoAReference &operator=(const VectorType &vector) const
+	{
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			(*this)[order] = vector[order];
+		}
+
+		return *this;
+	}
+
+	///
+	/// Returns the address of the first component; component $c$ is \ref stride elements after component $c - 1$.
+	///
+	constexpr ValueType *data() const
+	{
+		return this->_data;
+	}
+
+	constexpr std::size_t stride() const
+	{
+		return this->_stride;
+	}
+
+	constexpr ValueType &operator[](const std::size_t order) const
+	{
+		assert(order < Order);
+		return this->_data[order * this->_stride];
+	}
+
+	///
+	/// Gathers the components into a vector.
+	///
+	constexpr operator VectorType() const
 	{
 		VectorType returnValue;
 
-		this->subscript<0u>(returnValue, index);
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			returnValue[order] = (*this)[order];
+		}
 
 		return returnValue;
 	}
 
+	constexpr const VectorSoAReference &operator+=(const VectorType &vector) const
+	{
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			(*this)[order] += vector[order];
+		}
 
+		return *this;
+	}
 
-private:
-	struct SoA
+	constexpr const VectorSoAReference &operator-=(const VectorType &vector) const
 	{
-		std::vector<ValueType> data[Order];
-
-		constexpr std::vector<ValueType> &operator[](const std::size_t order)
+		for (std::size_t order = 0u; order < Order; ++order)
 		{
-			return data[order];
+			(*this)[order] -= vector[order];
 		}
-	};
 
-	SoA _data;
+		return *this;
+	}
 
-	template <std::size_t OrderIndex>
-	constexpr void subscript(VectorType &vector, const std::size_t index)
+	constexpr const VectorSoAReference &operator*=(const value_type scalar) const
 	{
-		vector[OrderIndex] = this->_data[OrderIndex][index];
-		subscript(vector, index + 1u);
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			(*this)[order] *= scalar;
+		}
+
+		return *this;
 	}
 
-	template <>
-	constexpr void subscript<Order - 1u>(VectorType &vector, const std::size_t index)
+	///
+	/// Exchanges the components of the referenced vectors, which lets algorithms like \c std::reverse or \c std::sort permute a VectorSoA.
+	///
+	friend constexpr void swap(const VectorSoAReference &left, const VectorSoAReference &right)
 	{
-		vector[Order - 1u] = this->_data[Order - 1u][index];
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			std::swap(left[order], right[order]);
+		}
 	}
+
+private:
+	ValueType	*_data		= nullptr;
+	std::size_t	_stride		= 0u;
 };
 
-}
+///
+/// Random access iterator over the vectors of a \ref VectorSoA, dereferencing to a \ref VectorSoAReference.
+///
+/// Dereferencing yields a proxy rather than a language reference, so the iterator models the random access iterator category of the standard
+/// algorithms, including their parallel overloads, but not the C++20 iterator concepts.
+///
+template <typename ValueType, std::size_t Order, typename Layout = layout::SoA>
+class VectorSoAIterator
+{
+	using Mapping = typename Layout::template Mapping<std::remove_const_t<ValueType>, Order>;
+
+public:
+	using iterator_category	= std::random_access_iterator_tag;
+	using value_type		= ColumnVector<std::remove_const_t<ValueType>, Order>;
+	using difference_type	= std::ptrdiff_t;
+	using reference			= VectorSoAReference<ValueType, Order>;
+	using pointer			= void;
+
+	constexpr VectorSoAIterator() = default;
+
+	///
+	/// Creates an iterator to the vector at \a index of the allocation at \a data holding \a capacity vectors.
+	///
+	constexpr VectorSoAIterator(ValueType *data, const std::size_t capacity, const difference_type index) :
+		_data(data),
+		_capacity(capacity),
+		_index(index)
+	{
+	}
+
+	template <typename Unused_ = void, typename = std::enable_if_t<std::is_const_v<ValueType>, Unused_>>
+	constexpr VectorSoAIterator(const VectorSoAIterator<std::remove_const_t<ValueType>, Order, Layout> &other) :
+		VectorSoAIterator(other.data(), other.capacity(), other.index())
+	{
+	}
+
+	constexpr ValueType *data() const
+	{
+		return this->_data;
+	}
+
+	constexpr std::size_t capacity() const
+	{
+		return this->_capacity;
+	}
+
+	constexpr difference_type index() const
+	{
+		return this->_index;
+	}
+
+	constexpr reference operator*() const
+	{
+		return (*this)[0];
+	}
+
+	constexpr reference operator[](const difference_type offset) const
+	{
+		return reference{this->_data + Mapping::offset(0u, std::size_t(this->_index + offset), this->_capacity), Mapping::stride(this->_capacity)};
+	}
+
+	constexpr VectorSoAIterator &operator++()
+	{
+		++this->_index;
+		return *this;
+	}
+
+	constexpr VectorSoAIterator operator++(int)
+	{
+		VectorSoAIterator returnValue = *this;
+		++this->_index;
+		return returnValue;
+	}
+
+	constexpr VectorSoAIterator &operator--()
+	{
+		--this->_index;
+		return *this;
+	}
+
+	constexpr VectorSoAIterator operator--(int)
+	{
+		VectorSoAIterator returnValue = *this;
+		--this->_index;
+		return returnValue;
+	}
+
+	constexpr VectorSoAIterator &operator+=(const difference_type offset)
+	{
+		this->_index += offset;
+		return *this;
+	}
+
+	constexpr VectorSoAIterator &operator-=(const difference_type offset)
+	{
+		this->_index -= offset;
+		return *this;
+	}
+
+	friend constexpr VectorSoAIterator operator+(VectorSoAIterator iterator, const difference_type offset)
+	{
+		return (iterator += offset);
+	}
+
+	friend constexpr VectorSoAIterator operator+(const difference_type offset, VectorSoAIterator iterator)
+	{
+		return (iterator += offset);
+	}
+
+	friend constexpr VectorSoAIterator operator-(VectorSoAIterator iterator, const difference_type offset)
+	{
+		return (iterator -= offset);
+	}
+
+	friend constexpr difference_type operator-(const VectorSoAIterator &left, const VectorSoAIterator &right)
+	{
+		return (left._index - right._index);
+	}
+
+	friend constexpr bool operator==(const VectorSoAIterator &left, const VectorSoAIterator &right)
+	{
+		return (left._index == right._index);
+	}
+
+	friend constexpr auto operator<=>(const VectorSoAIterator &left, const VectorSoAIterator &right)
+	{
+		return (left._index <=> right._index);
+	}
+
+private:
+	ValueType		*_data		= nullptr;
+	std::size_t		_capacity	= 0u;
+	difference_type	_index		= 0;
+};
+
+///
+/// Non-owning view of a range of consecutive vectors of a \ref VectorSoA, the common currency of the batch kernels and parallel algorithms.
+///
+/// A view addresses vectors relative to its first one. It stays valid until the viewed container reallocates. Use a const \a ValueType for
+/// read-only views.
+///
+template <typename ValueType, std::size_t Order, typename Layout = layout::SoA>
+class VectorSoAView
+{
+public:
+	using Mapping			= typename Layout::template Mapping<std::remove_const_t<ValueType>, Order>;
+	using VectorType		= ColumnVector<std::remove_const_t<ValueType>, Order>;
+	using value_type		= VectorType;
+	using size_type			= std::size_t;
+	using difference_type	= std::ptrdiff_t;
+	using reference			= VectorSoAReference<ValueType, Order>;
+	using iterator			= VectorSoAIterator<ValueType, Order, Layout>;
+	using ConstView			= VectorSoAView<const std::remove_const_t<ValueType>, Order, Layout>;
+
+	constexpr VectorSoAView() = default;
+
+	///
+	/// Creates a view of the \a size vectors starting at \a offset in the allocation at \a data holding \a capacity vectors.
+	///
+	constexpr VectorSoAView(ValueType *data, const std::size_t capacity, const std::size_t offset, const std::size_t size) :
+		_data(data),
+		_capacity(capacity),
+		_offset(offset),
+		_size(size)
+	{
+		assert((offset + size) <= capacity);
+	}
+
+	template <typename Unused_ = void, typename = std::enable_if_t<std::is_const_v<ValueType>, Unused_>>
+	constexpr VectorSoAView(const VectorSoAView<std::remove_const_t<ValueType>, Order, Layout> &other) :
+		VectorSoAView(other.allocation(), other.capacity(), other.offset(), other.size())
+	{
+	}
+
+	///
+	/// Returns the start of the viewed allocation, which is not the first vector of the view unless \ref offset is zero.
+	///
+	constexpr ValueType *allocation() const
+	{
+		return this->_data;
+	}
+
+	constexpr std::size_t capacity() const
+	{
+		return this->_capacity;
+	}
+
+	///
+	/// Returns the index of the first vector of the view in the viewed container.
+	///
+	constexpr std::size_t offset() const
+	{
+		return this->_offset;
+	}
+
+	constexpr std::size_t size() const
+	{
+		return this->_size;
+	}
+
+	constexpr bool empty() const
+	{
+		return (this->_size == 0u);
+	}
+
+	///
+	/// Returns the address of component \a order of the vector at \a index, see \ref VectorSoA::data(std::size_t, std::size_t).
+	///
+	constexpr ValueType *data(const std::size_t order, const std::size_t index) const
+	{
+		assert((order < Order) & (index <= this->_size));
+		return this->_data + Mapping::offset(order, this->_offset + index, this->_capacity);
+	}
+
+	constexpr reference operator[](const std::size_t index) const
+	{
+		assert(index < this->_size);
+		return reference{this->data(0u, index), Mapping::stride(this->_capacity)};
+	}
+
+	constexpr iterator begin() const
+	{
+		return iterator{this->_data, this->_capacity, difference_type(this->_offset)};
+	}
+
+	constexpr iterator end() const
+	{
+		return iterator{this->_data, this->_capacity, difference_type(this->_offset + this->_size)};
+	}
+
+	///
+	/// Returns a view of the \a count vectors starting at \a index of this view.
+	///
+	constexpr VectorSoAView subview(const std::size_t index, const std::size_t count) const
+	{
+		assert((index + count) <= this->_size);
+		return VectorSoAView{this->_data, this->_capacity, this->_offset + index, count};
+	}
+
+private:
+	ValueType	*_data		= nullptr;
+	std::size_t	_capacity	= 0u;
+	std::size_t	_offset		= 0u;
+	std::size_t	_size		= 0u;
+};
+
+///
+/// Container of \a Order dimensional vectors stored as a structure of arrays: component $c$ of all vectors is contiguous, so kernels process
+/// as many vectors per instruction as a register holds instead of gathering the components of a single vector.
+///
+/// All components live in a single cache line aligned allocation. Every component occupies \ref capacity elements, rounded up to whole cache
+/// lines, so each component array starts aligned as well. Like \ref DynamicMatrix a VectorSoA can be moved but not copied implicitly, use
+/// \ref clone for an explicit deep copy.
+///
+/// \a Layout selects where components live: \ref layout::SoA as described above, or \ref layout::AoSoA to interleave blocks of each
+/// component so all components of a vector share a few cache lines, which favors random access. Access through references, iterators and
+/// \ref data(std::size_t, std::size_t) works the same for both; contiguous component arrays are only available with \ref layout::SoA.
+///
+template <typename ValueType, std::size_t Order, typename Layout = layout::SoA>
+class VectorSoA
+{
+	static_assert(Order > 0u, "VectorSoA requires at least one component");
+
+public:
+	using Mapping			= typename Layout::template Mapping<ValueType, Order>;
+	using VectorType		= ColumnVector<ValueType, Order>;
+	using value_type		= VectorType;
+	using size_type			= std::size_t;
+	using difference_type	= std::ptrdiff_t;
+	using reference			= VectorSoAReference<ValueType, Order>;
+	using const_reference	= VectorSoAReference<const ValueType, Order>;
+	using iterator			= VectorSoAIterator<ValueType, Order, Layout>;
+	using const_iterator	= VectorSoAIterator<const ValueType, Order, Layout>;
+	using View				= VectorSoAView<ValueType, Order, Layout>;
+	using ConstView			= VectorSoAView<const ValueType, Order, Layout>;
+
+	VectorSoA() = default;
+
+	///
+	/// Creates \a size zero initialized vectors.
+	///
+	explicit VectorSoA(const std::size_t size)
+	{
+		this->resize(size);
+	}
+
+	///
+	/// Creates a copy of the vectors in \a vectors, see \ref assign.
+	///
+	template <typename Range, typename = std::enable_if_t<detail::isInterleavedRange<const Range &, ValueType, Order>()>>
+	explicit VectorSoA(const Range &vectors)
+	{
+		this->assign(vectors);
+	}
+
+	VectorSoA(const VectorSoA &other) = delete;
+
+	VectorSoA(VectorSoA &&other) noexcept :
+		_data(std::move(other._data)),
+		_size(std::exchange(other._size, 0u)),
+		_capacity(std::exchange(other._capacity, 0u))
+	{
+	}
+
+	VectorSoA &operator=(const VectorSoA &other) = delete;
+
+	VectorSoA &operator=(VectorSoA &&other) noexcept
+	{
+		this->_data		= std::move(other._data);
+		this->_size		= std::exchange(other._size, 0u);
+		this->_capacity	= std::exchange(other._capacity, 0u);
+
+		return *this;
+	}
+
+	VectorSoA clone() const
+	{
+		VectorSoA returnValue;
+
+		returnValue.reserve(this->_size);
+		returnValue._size = this->_size;
+
+		VectorSoA::copy(returnValue._data.data(), returnValue._capacity, this->_data.data(), this->_capacity, this->_size);
+
+		return returnValue;
+	}
+
+	std::size_t size() const
+	{
+		return this->_size;
+	}
+
+	///
+	/// Returns the number of vectors that fit without reallocating, which is also the distance between two component arrays of a
+	/// \ref layout::SoA.
+	///
+	std::size_t capacity() const
+	{
+		return this->_capacity;
+	}
+
+	bool empty() const
+	{
+		return (this->_size == 0u);
+	}
+
+	///
+	/// Makes room for at least \a capacity vectors, keeping the current ones.
+	///
+	void reserve(const std::size_t capacity)
+	{
+		if (capacity <= this->_capacity)
+		{
+			return;
+		}
+
+		const std::size_t alignedCapacity = detail::roundUp(capacity, Mapping::granularity);
+
+		memory::AlignedBuffer<ValueType> data{alignedCapacity * Order};
+
+		VectorSoA::copy(data.data(), alignedCapacity, this->_data.data(), this->_capacity, this->_size);
+
+		this->_data		= std::move(data);
+		this->_capacity	= alignedCapacity;
+	}
+
+	///
+	/// Changes the number of vectors to \a size. Added vectors are zero initialized.
+	///
+	void resize(const std::size_t size)
+	{
+		if (size > this->_capacity)
+		{
+			this->reserve(std::max(size, 2u * this->_capacity));
+		}
+
+		VectorSoA::forEachRun(this->_size, size, Mapping::run(this->_capacity), [this](const std::size_t index, const std::size_t count)
+		{
+			for (std::size_t order = 0u; order < Order; ++order)
+			{
+				common::setZero(this->data(order, index), count);
+			}
+		});
+
+		this->_size = size;
+	}
+
+	void clear()
+	{
+		this->_size = 0u;
+	}
+
+	///
+	/// Replaces all vectors by the row or column vectors of the contiguous range \a vectors, for example a \c std::vector<Vector3_f>.
+	///
+	/// Their components are separated with register shuffles, a vector register of each component at a time, instead of being scattered
+	/// element by element.
+	///
+	template <typename Range, typename = std::enable_if_t<detail::isInterleavedRange<const Range &, ValueType, Order>()>>
+	void assign(const Range &vectors)
+	{
+		const std::size_t	size	= std::ranges::size(vectors);
+		const ValueType		*source	= VectorSoA::components(std::ranges::data(vectors));
+
+		this->_size = 0u;
+		this->reserve(size);
+		this->_size = size;
+
+		VectorSoA::forEachRun(0u, size, Mapping::run(this->_capacity), [this, source](const std::size_t index, const std::size_t count)
+		{
+			ValueType *destinations[Order];
+
+			for (std::size_t order = 0u; order < Order; ++order)
+			{
+				destinations[order] = this->data(order, index);
+			}
+
+			detail::deinterleave<Order, Mapping::lanes>(source + index * Order, count, destinations);
+		});
+	}
+
+	///
+	/// Copies all vectors to the contiguous range \a vectors of row or column vectors with the same size, interleaving their components
+	/// with register shuffles.
+	///
+	template <typename Range, typename = std::enable_if_t<detail::isInterleavedRange<Range, ValueType, Order>() &&
+														  !std::is_const_v<std::remove_reference_t<std::ranges::range_reference_t<Range>>>>>
+	void copyTo(Range &&vectors) const
+	{
+		assert(std::ranges::size(vectors) == this->_size);
+
+		ValueType *destination = VectorSoA::components(std::ranges::data(vectors));
+
+		VectorSoA::forEachRun(0u, this->_size, Mapping::run(this->_capacity), [this, destination](const std::size_t index, const std::size_t count)
+		{
+			const ValueType *sources[Order];
+
+			for (std::size_t order = 0u; order < Order; ++order)
+			{
+				sources[order] = this->data(order, index);
+			}
+
+			detail::interleave<Order, Mapping::lanes>(sources, count, destination + index * Order);
+		});
+	}
+
+	void push_back(const VectorType &vector)
+	{
+		this->grow();
+
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			*this->data(order, this->_size) = vector[order];
+		}
+
+		this->_size++;
+	}
+
+	///
+	/// Appends the vector with the \a Order given components.
+	///
+	template <typename... Components, typename = std::enable_if_t<(sizeof... (Components) == Order)>>
+	void emplace_back(const Components... components)
+	{
+		this->grow();
+
+		std::size_t order = 0u;
+		((*this->data(order++, this->_size) = static_cast<ValueType>(components)), ...);
+
+		this->_size++;
+	}
+
+	void pop_back()
+	{
+		assert(this->_size > 0u);
+		this->_size--;
+	}
+
+	///
+	/// Returns the contiguous array of component \a order of all vectors.
+	///
+	template <typename Unused_ = void, typename = std::enable_if_t<Mapping::contiguous, Unused_>>
+	std::span<ValueType> component(const std::size_t order)
+	{
+		return std::span<ValueType>{this->data(order), this->_size};
+	}
+
+	template <typename Unused_ = void, typename = std::enable_if_t<Mapping::contiguous, Unused_>>
+	std::span<const ValueType> component(const std::size_t order) const
+	{
+		return std::span<const ValueType>{this->data(order), this->_size};
+	}
+
+	template <typename Unused_ = void, typename = std::enable_if_t<Mapping::contiguous, Unused_>>
+	ValueType *data(const std::size_t order)
+	{
+		return this->data(order, 0u);
+	}
+
+	template <typename Unused_ = void, typename = std::enable_if_t<Mapping::contiguous, Unused_>>
+	const ValueType *data(const std::size_t order) const
+	{
+		return this->data(order, 0u);
+	}
+
+	///
+	/// Returns the address of component \a order of the vector at \a index. The following components of the next vectors are contiguous up
+	/// to the end of the current run of \ref Mapping::run vectors.
+	///
+	ValueType *data(const std::size_t order, const std::size_t index)
+	{
+		assert((order < Order) & (index <= this->_capacity));
+		return this->_data.data() + Mapping::offset(order, index, this->_capacity);
+	}
+
+	const ValueType *data(const std::size_t order, const std::size_t index) const
+	{
+		assert((order < Order) & (index <= this->_capacity));
+		return this->_data.data() + Mapping::offset(order, index, this->_capacity);
+	}
+
+	///
+	/// Returns a reference to the vector at \a index, which accesses its components in place.
+	///
+	reference operator[](const std::size_t index)
+	{
+		assert(index < this->_size);
+		return reference{this->data(0u, index), Mapping::stride(this->_capacity)};
+	}
+
+	const_reference operator[](const std::size_t index) const
+	{
+		assert(index < this->_size);
+		return const_reference{this->data(0u, index), Mapping::stride(this->_capacity)};
+	}
+
+	View view()
+	{
+		return View{this->_data.data(), this->_capacity, 0u, this->_size};
+	}
+
+	ConstView view() const
+	{
+		return ConstView{this->_data.data(), this->_capacity, 0u, this->_size};
+	}
+
+	///
+	/// Returns a view of the \a count vectors starting at \a index.
+	///
+	View view(const std::size_t index, const std::size_t count)
+	{
+		return this->view().subview(index, count);
+	}
+
+	ConstView view(const std::size_t index, const std::size_t count) const
+	{
+		return this->view().subview(index, count);
+	}
+
+	iterator begin()
+	{
+		return iterator{this->_data.data(), this->_capacity, 0};
+	}
+
+	iterator end()
+	{
+		return iterator{this->_data.data(), this->_capacity, difference_type(this->_size)};
+	}
+
+	const_iterator begin() const
+	{
+		return const_iterator{this->_data.data(), this->_capacity, 0};
+	}
+
+	const_iterator end() const
+	{
+		return const_iterator{this->_data.data(), this->_capacity, difference_type(this->_size)};
+	}
+
+	const_iterator cbegin() const
+	{
+		return this->begin();
+	}
+
+	const_iterator cend() const
+	{
+		return this->end();
+	}
+
+private:
+	memory::AlignedBuffer<ValueType>	_data;
+	std::size_t							_size		= 0u;
+	std::size_t							_capacity	= 0u;
+
+	///
+	/// Calls \a function with the first index and the length of every run of contiguous components within $[begin, end)$.
+	///
+	template <typename Function>
+	static void forEachRun(std::size_t begin, const std::size_t end, const std::size_t run, const Function &function)
+	{
+		while (begin < end)
+		{
+			const std::size_t count = std::min(end, (begin / run + 1u) * run) - begin;
+
+			function(begin, count);
+			begin += count;
+		}
+	}
+
+	///
+	/// Returns the components of the packed row or column vectors at \a vectors as one array.
+	///
+	template <typename Vector>
+	static auto components(Vector *vectors)
+	{
+		static_assert(std::is_standard_layout_v<Vector> & (sizeof (Vector) == Order * sizeof (ValueType)), "Vectors have to be packed");
+
+		using Pointer = std::conditional_t<std::is_const_v<Vector>, const ValueType *, ValueType *>;
+		return reinterpret_cast<Pointer>(vectors);
+	}
+
+	///
+	/// Copies the first \a size vectors between allocations of different capacities.
+	///
+	static void copy(ValueType *destination, const std::size_t destinationCapacity, const ValueType *source, const std::size_t sourceCapacity,
+					 const std::size_t size)
+	{
+		const std::size_t run = std::min(Mapping::run(destinationCapacity), Mapping::run(sourceCapacity));
+
+		VectorSoA::forEachRun(0u, size, run, [=](const std::size_t index, const std::size_t count)
+		{
+			for (std::size_t order = 0u; order < Order; ++order)
+			{
+				common::copy(destination + Mapping::offset(order, index, destinationCapacity), source + Mapping::offset(order, index, sourceCapacity),
+							 count);
+			}
+		});
+	}
+
+	void grow()
+	{
+		if (this->_size == this->_capacity)
+		{
+			this->reserve(std::max<std::size_t>(2u * this->_capacity, Mapping::granularity));
+		}
+	}
+};
+
+///
+/// Writes the dot products of the corresponding vectors of \a left and \a right to \a result.
+///
+/// Like the other batch kernels below it works on the component arrays directly, a full vector register of vectors per instruction, and
+/// requires all arguments to have the same size. Results may alias the operands. Every kernel takes views, so it can process a chunk of a
+/// container as well, and has an overload for whole containers.
+///
+template <typename Left, typename Right, std::size_t Order, typename Layout>
+void dot(const VectorSoAView<Left, Order, Layout> left, const VectorSoAView<Right, Order, Layout> right, const std::span<std::remove_const_t<Left>> result)
+{
+	using ValueType	= std::remove_const_t<Left>;
+	using Mapping	= typename VectorSoAView<Left, Order, Layout>::Mapping;
+
+	static_assert(std::is_same_v<ValueType, std::remove_const_t<Right>>, "Operands have to share their element type");
+	assert((left.size() == right.size()) & (left.size() == result.size()));
+
+	const std::size_t head = detail::batchHead<Mapping>(left.size(), left.offset(), right.offset());
+
+	detail::batch<ValueType, Mapping::lanes>(head, left.size(), [left, right, result](const std::size_t index, auto lane)
+	{
+		using Lane = decltype(lane);
+
+		Lane sum = detail::batchLoad<Lane>(left.data(0u, index)) * detail::batchLoad<Lane>(right.data(0u, index));
+
+		for (std::size_t order = 1u; order < Order; ++order)
+		{
+			sum += detail::batchLoad<Lane>(left.data(order, index)) * detail::batchLoad<Lane>(right.data(order, index));
+		}
+
+		detail::batchStore(result.data() + index, sum);
+	});
+}
+
+template <typename ValueType, std::size_t Order, typename Layout>
+void dot(const VectorSoA<ValueType, Order, Layout> &left, const VectorSoA<ValueType, Order, Layout> &right, const std::span<ValueType> result)
+{
+	dot(left.view(), right.view(), result);
+}
+
+template <typename ValueType, std::size_t Order, typename Layout>
+void squareNorm(const VectorSoAView<ValueType, Order, Layout> vectors, const std::span<std::remove_const_t<ValueType>> result)
+{
+	dot(vectors, vectors, result);
+}
+
+template <typename ValueType, std::size_t Order, typename Layout>
+void squareNorm(const VectorSoA<ValueType, Order, Layout> &vectors, const std::span<ValueType> result)
+{
+	dot(vectors.view(), vectors.view(), result);
+}
+
+template <typename ValueType, std::size_t Order, typename Layout>
+void norm(const VectorSoAView<ValueType, Order, Layout> vectors, const std::span<std::remove_const_t<ValueType>> result)
+{
+	using Mapping = typename VectorSoAView<ValueType, Order, Layout>::Mapping;
+
+	assert(vectors.size() == result.size());
+
+	const std::size_t head = detail::batchHead<Mapping>(vectors.size(), vectors.offset());
+
+	detail::batch<std::remove_const_t<ValueType>, Mapping::lanes>(head, vectors.size(), [vectors, result](const std::size_t index, auto lane)
+	{
+		using Lane = decltype(lane);
+
+		Lane sum = {};
+
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			const Lane component = detail::batchLoad<Lane>(vectors.data(order, index));
+			sum += component * component;
+		}
+
+		detail::batchStore(result.data() + index, detail::batchSquareRoot<std::remove_const_t<ValueType>>(sum));
+	});
+}
+
+template <typename ValueType, std::size_t Order, typename Layout>
+void norm(const VectorSoA<ValueType, Order, Layout> &vectors, const std::span<ValueType> result)
+{
+	norm(vectors.view(), result);
+}
+
+///
+/// Writes the cross products of the corresponding vectors of \a left and \a right to \a result, which may be one of the operands.
+///
+template <typename ValueType, typename Layout>
+void cross(const typename VectorSoAView<ValueType, 3u, Layout>::ConstView left,
+		   const typename VectorSoAView<ValueType, 3u, Layout>::ConstView right, const VectorSoAView<ValueType, 3u, Layout> result)
+{
+	using Mapping = typename VectorSoAView<ValueType, 3u, Layout>::Mapping;
+
+	assert((left.size() == right.size()) & (left.size() == result.size()));
+
+	const std::size_t head = detail::batchHead<Mapping>(left.size(), left.offset(), right.offset(), result.offset());
+
+	detail::batch<ValueType, Mapping::lanes>(head, left.size(), [left, right, result](const std::size_t index, auto lane)
+	{
+		using Lane = decltype(lane);
+
+		const Lane lx = detail::batchLoad<Lane>(left.data(0u, index));
+		const Lane ly = detail::batchLoad<Lane>(left.data(1u, index));
+		const Lane lz = detail::batchLoad<Lane>(left.data(2u, index));
+		const Lane rx = detail::batchLoad<Lane>(right.data(0u, index));
+		const Lane ry = detail::batchLoad<Lane>(right.data(1u, index));
+		const Lane rz = detail::batchLoad<Lane>(right.data(2u, index));
+
+		detail::batchStore(result.data(0u, index), Lane(ly * rz - lz * ry));
+		detail::batchStore(result.data(1u, index), Lane(lz * rx - lx * rz));
+		detail::batchStore(result.data(2u, index), Lane(lx * ry - ly * rx));
+	});
+}
+
+template <typename ValueType, typename Layout>
+void cross(const VectorSoA<ValueType, 3u, Layout> &left, const VectorSoA<ValueType, 3u, Layout> &right, VectorSoA<ValueType, 3u, Layout> &result)
+{
+	cross(left.view(), right.view(), result.view());
+}
+
+///
+/// Scales every vector of \a vectors to unit length. Vectors of length zero become NaN, like with \ref Matrix::normalize.
+///
+template <typename ValueType, std::size_t Order, typename Layout>
+void normalize(const VectorSoAView<ValueType, Order, Layout> vectors)
+{
+	using Mapping = typename VectorSoAView<ValueType, Order, Layout>::Mapping;
+
+	const std::size_t head = detail::batchHead<Mapping>(vectors.size(), vectors.offset());
+
+	detail::batch<ValueType, Mapping::lanes>(head, vectors.size(), [vectors](const std::size_t index, auto lane)
+	{
+		using Lane = decltype(lane);
+
+		Lane components[Order];
+		Lane sum = {};
+
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			components[order]	= detail::batchLoad<Lane>(vectors.data(order, index));
+			sum					+= components[order] * components[order];
+		}
+
+		const Lane length = detail::batchSquareRoot<ValueType>(sum);
+
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			detail::batchStore(vectors.data(order, index), Lane(components[order] / length));
+		}
+	});
+}
+
+template <typename ValueType, std::size_t Order, typename Layout>
+void normalize(VectorSoA<ValueType, Order, Layout> &vectors)
+{
+	normalize(vectors.view());
+}
+
+///
+/// Multiplies every vector of \a vectors by \a scalar.
+///
+template <typename ValueType, std::size_t Order, typename Layout>
+void scale(const VectorSoAView<ValueType, Order, Layout> vectors, const std::type_identity_t<ValueType> scalar)
+{
+	using Mapping = typename VectorSoAView<ValueType, Order, Layout>::Mapping;
+
+	const std::size_t head = detail::batchHead<Mapping>(vectors.size(), vectors.offset());
+
+	detail::batch<ValueType, Mapping::lanes>(head, vectors.size(), [vectors, scalar](const std::size_t index, auto lane)
+	{
+		using Lane = decltype(lane);
+
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			detail::batchStore(vectors.data(order, index), Lane(detail::batchLoad<Lane>(vectors.data(order, index)) * scalar));
+		}
+	});
+}
+
+template <typename ValueType, std::size_t Order, typename Layout>
+void scale(VectorSoA<ValueType, Order, Layout> &vectors, const std::type_identity_t<ValueType> scalar)
+{
+	scale(vectors.view(), scalar);
+}
+
+///
+/// Computes $y = \alpha x + y$ for the corresponding vectors of \a x and \a y.
+///
+template <typename ValueType, std::size_t Order, typename Layout>
+void axpy(const std::type_identity_t<ValueType> alpha, const typename VectorSoAView<ValueType, Order, Layout>::ConstView x,
+		  const VectorSoAView<ValueType, Order, Layout> y)
+{
+	using Mapping = typename VectorSoAView<ValueType, Order, Layout>::Mapping;
+
+	assert(x.size() == y.size());
+
+	const std::size_t head = detail::batchHead<Mapping>(x.size(), x.offset(), y.offset());
+
+	detail::batch<ValueType, Mapping::lanes>(head, x.size(), [x, y, alpha](const std::size_t index, auto lane)
+	{
+		using Lane = decltype(lane);
+
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			const Lane result = alpha * detail::batchLoad<Lane>(x.data(order, index)) + detail::batchLoad<Lane>(y.data(order, index));
+			detail::batchStore(y.data(order, index), result);
+		}
+	});
+}
+
+template <typename ValueType, std::size_t Order, typename Layout>
+void axpy(const std::type_identity_t<ValueType> alpha, const VectorSoA<ValueType, Order, Layout> &x, VectorSoA<ValueType, Order, Layout> &y)
+{
+	axpy(alpha, x.view(), y.view());
+}
+
+///
+/// Writes the points \a points transformed by the affine transformation \a matrix to \a result, which may be \a points itself. Points are
+/// column vectors with an implicit fourth component of one, so the last row of \a matrix is ignored; use \ref projectPoints for projective
+/// transformations.
+///
+/// The kernel works on a copy of \a matrix, so its elements are broadcast into registers once instead of being reloaded after every store
+/// to \a result; every register of points then takes nine fused multiply-adds.
+///
+template <typename ValueType, typename Layout>
+void transformPoints(const Matrix<ValueType, 4u, 4u> &matrix, const typename VectorSoAView<ValueType, 3u, Layout>::ConstView points,
+					 const VectorSoAView<ValueType, 3u, Layout> result)
+{
+	using Mapping = typename VectorSoAView<ValueType, 3u, Layout>::Mapping;
+
+	assert(points.size() == result.size());
+
+	const std::size_t head = detail::batchHead<Mapping>(points.size(), points.offset(), result.offset());
+
+	detail::batch<ValueType, Mapping::lanes>(head, points.size(), [m = matrix, points, result](const std::size_t index, auto lane)
+	{
+		using Lane = decltype(lane);
+
+		const Lane x = detail::batchLoad<Lane>(points.data(0u, index));
+		const Lane y = detail::batchLoad<Lane>(points.data(1u, index));
+		const Lane z = detail::batchLoad<Lane>(points.data(2u, index));
+
+		for (std::size_t row = 0u; row < 3u; ++row)
+		{
+			detail::batchStore(result.data(row, index), Lane(x * m[row][0u] + y * m[row][1u] + z * m[row][2u] + m[row][3u]));
+		}
+	});
+}
+
+template <typename ValueType, typename Layout>
+void transformPoints(const Matrix<ValueType, 4u, 4u> &matrix, const VectorSoA<ValueType, 3u, Layout> &points, VectorSoA<ValueType, 3u, Layout> &result)
+{
+	transformPoints(matrix, points.view(), result.view());
+}
+
+template <typename ValueType, typename Layout>
+void transformPoints(const Matrix<ValueType, 4u, 4u> &matrix, VectorSoA<ValueType, 3u, Layout> &points)
+{
+	transformPoints(matrix, points.view(), points.view());
+}
+
+///
+/// Writes the directions \a directions transformed by \a matrix to \a result, which may be \a directions itself. Directions have an implicit
+/// fourth component of zero, so only the upper left 3x3 block of \a matrix applies and translations leave them unchanged.
+///
+template <typename ValueType, typename Layout>
+void transformDirections(const Matrix<ValueType, 4u, 4u> &matrix, const typename VectorSoAView<ValueType, 3u, Layout>::ConstView directions,
+						 const VectorSoAView<ValueType, 3u, Layout> result)
+{
+	using Mapping = typename VectorSoAView<ValueType, 3u, Layout>::Mapping;
+
+	assert(directions.size() == result.size());
+
+	const std::size_t head = detail::batchHead<Mapping>(directions.size(), directions.offset(), result.offset());
+
+	detail::batch<ValueType, Mapping::lanes>(head, directions.size(), [m = matrix, directions, result](const std::size_t index, auto lane)
+	{
+		using Lane = decltype(lane);
+
+		const Lane x = detail::batchLoad<Lane>(directions.data(0u, index));
+		const Lane y = detail::batchLoad<Lane>(directions.data(1u, index));
+		const Lane z = detail::batchLoad<Lane>(directions.data(2u, index));
+
+		for (std::size_t row = 0u; row < 3u; ++row)
+		{
+			detail::batchStore(result.data(row, index), Lane(x * m[row][0u] + y * m[row][1u] + z * m[row][2u]));
+		}
+	});
+}
+
+template <typename ValueType, typename Layout>
+void transformDirections(const Matrix<ValueType, 4u, 4u> &matrix, const VectorSoA<ValueType, 3u, Layout> &directions,
+						 VectorSoA<ValueType, 3u, Layout> &result)
+{
+	transformDirections(matrix, directions.view(), result.view());
+}
+
+template <typename ValueType, typename Layout>
+void transformDirections(const Matrix<ValueType, 4u, 4u> &matrix, VectorSoA<ValueType, 3u, Layout> &directions)
+{
+	transformDirections(matrix, directions.view(), directions.view());
+}
+
+///
+/// Writes the points \a points transformed by the projective transformation \a matrix, such as a view projection, to \a result, which may be
+/// \a points itself. Each transformed point is divided by its fourth component, so the results are normalized device coordinates for a
+/// projection. Points with a fourth component of zero become infinite or NaN.
+///
+template <typename ValueType, typename Layout>
+void projectPoints(const Matrix<ValueType, 4u, 4u> &matrix, const typename VectorSoAView<ValueType, 3u, Layout>::ConstView points,
+				   const VectorSoAView<ValueType, 3u, Layout> result)
+{
+	using Mapping = typename VectorSoAView<ValueType, 3u, Layout>::Mapping;
+
+	assert(points.size() == result.size());
+
+	const std::size_t head = detail::batchHead<Mapping>(points.size(), points.offset(), result.offset());
+
+	detail::batch<ValueType, Mapping::lanes>(head, points.size(), [m = matrix, points, result](const std::size_t index, auto lane)
+	{
+		using Lane = decltype(lane);
+
+		const Lane x = detail::batchLoad<Lane>(points.data(0u, index));
+		const Lane y = detail::batchLoad<Lane>(points.data(1u, index));
+		const Lane z = detail::batchLoad<Lane>(points.data(2u, index));
+		const Lane w = x * m[3u][0u] + y * m[3u][1u] + z * m[3u][2u] + m[3u][3u];
+
+		for (std::size_t row = 0u; row < 3u; ++row)
+		{
+			detail::batchStore(result.data(row, index), Lane((x * m[row][0u] + y * m[row][1u] + z * m[row][2u] + m[row][3u]) / w));
+		}
+	});
+}
+
+template <typename ValueType, typename Layout>
+void projectPoints(const Matrix<ValueType, 4u, 4u> &matrix, const VectorSoA<ValueType, 3u, Layout> &points, VectorSoA<ValueType, 3u, Layout> &result)
+{
+	projectPoints(matrix, points.view(), result.view());
+}
+
+template <typename ValueType, typename Layout>
+void projectPoints(const Matrix<ValueType, 4u, 4u> &matrix, VectorSoA<ValueType, 3u, Layout> &points)
+{
+	projectPoints(matrix, points.view(), points.view());
+}
+
+///
+/// Bounds, component sums and number of a set of vectors, which \ref statistics gathers in a single pass over memory.
+///
+/// Statistics of disjoint sets combine with \ref merge; default constructed statistics describe the empty set and are its identity.
+///
+template <typename ValueType, std::size_t Order>
+struct VectorStatistics
+{
+	using VectorType = ColumnVector<ValueType, Order>;
+
+	BoundingBox<ValueType, Order>	bounds	= BoundingBox<ValueType, Order>::empty();
+	VectorType						sum		= VectorType{traits::initialization::zero};
+	std::size_t						count	= 0u;
+
+	///
+	/// Returns the mean of all vectors, which is NaN for an empty set of floating point vectors.
+	///
+	constexpr VectorType centroid() const
+	{
+		return this->sum / static_cast<ValueType>(this->count);
+	}
+
+	constexpr VectorStatistics &merge(const VectorStatistics &other)
+	{
+		this->bounds.merge(other.bounds);
+		this->sum	+= other.sum;
+		this->count	+= other.count;
+
+		return *this;
+	}
+};
+
+///
+/// Returns the bounding box, the component sums and the number of the vectors of \a vectors.
+///
+/// The kernel keeps one minimum, maximum and sum per lane of a vector register in an accumulator array the compiler holds in registers, and
+/// folds the lanes once at the end. Components that are NaN are ignored by the bounds but propagate into the sums.
+///
+template <typename ValueType, std::size_t Order, typename Layout>
+VectorStatistics<std::remove_const_t<ValueType>, Order> statistics(const VectorSoAView<ValueType, Order, Layout> vectors)
+{
+	using Element	= std::remove_const_t<ValueType>;
+	using Mapping	= typename VectorSoAView<ValueType, Order, Layout>::Mapping;
+
+	constexpr std::size_t lanes = Mapping::lanes;
+
+	VectorStatistics<Element, Order> returnValue;
+
+	// The scalar head and tail accumulate into lane zero
+	Element minimum[Order][lanes];
+	Element maximum[Order][lanes];
+	Element sum[Order][lanes] = {};
+
+	for (std::size_t order = 0u; order < Order; ++order)
+	{
+		std::fill_n(minimum[order], lanes, returnValue.bounds.minimum[order]);
+		std::fill_n(maximum[order], lanes, returnValue.bounds.maximum[order]);
+	}
+
+	const std::size_t head = detail::batchHead<Mapping>(vectors.size(), vectors.offset());
+
+	detail::batch<Element, lanes>(head, vectors.size(), [vectors, &minimum, &maximum, &sum](const std::size_t index, auto lane)
+	{
+		using Lane = decltype(lane);
+
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			const Lane component	= detail::batchLoad<Lane>(vectors.data(order, index));
+			const Lane low			= detail::batchLoad<Lane>(minimum[order]);
+			const Lane high			= detail::batchLoad<Lane>(maximum[order]);
+
+			detail::batchStore(minimum[order], Lane(component < low ? component : low));
+			detail::batchStore(maximum[order], Lane(component > high ? component : high));
+			detail::batchStore(sum[order], Lane(detail::batchLoad<Lane>(sum[order]) + component));
+		}
+	});
+
+	for (std::size_t order = 0u; order < Order; ++order)
+	{
+		for (std::size_t lane = 0u; lane < lanes; ++lane)
+		{
+			returnValue.bounds.minimum[order]	= std::min(returnValue.bounds.minimum[order], minimum[order][lane]);
+			returnValue.bounds.maximum[order]	= std::max(returnValue.bounds.maximum[order], maximum[order][lane]);
+			returnValue.sum[order]				+= sum[order][lane];
+		}
+	}
+
+	returnValue.count = vectors.size();
+
+	return returnValue;
+}
+
+template <typename ValueType, std::size_t Order, typename Layout>
+VectorStatistics<ValueType, Order> statistics(const VectorSoA<ValueType, Order, Layout> &vectors)
+{
+	return statistics(vectors.view());
+}
+
+///
+/// Returns the axis-aligned bounding box of \a vectors, whose minimum and maximum are the per-component extrema.
+///
+template <typename ValueType, std::size_t Order, typename Layout>
+BoundingBox<std::remove_const_t<ValueType>, Order> bounds(const VectorSoAView<ValueType, Order, Layout> vectors)
+{
+	return statistics(vectors).bounds;
+}
+
+template <typename ValueType, std::size_t Order, typename Layout>
+BoundingBox<ValueType, Order> bounds(const VectorSoA<ValueType, Order, Layout> &vectors)
+{
+	return statistics(vectors.view()).bounds;
+}
+
+template <typename ValueType, std::size_t Order, typename Layout>
+ColumnVector<std::remove_const_t<ValueType>, Order> centroid(const VectorSoAView<ValueType, Order, Layout> vectors)
+{
+	return statistics(vectors).centroid();
+}
+
+template <typename ValueType, std::size_t Order, typename Layout>
+ColumnVector<ValueType, Order> centroid(const VectorSoA<ValueType, Order, Layout> &vectors)
+{
+	return statistics(vectors.view()).centroid();
+}
+
+namespace detail
+{
+
+///
+/// Default number of vectors per chunk of the parallel algorithms: large enough to amortize scheduling, small enough to balance the load
+/// of tens of millions of vectors across many threads.
+///
+inline constexpr std::size_t parallelGrainSize = 16384u;
+
+///
+/// Returns \a grainSize rounded up to whole cache lines of each component and whole vector registers, so the batch kernels never split a
+/// register across chunks and chunks never share a cache line.
+///
+template <typename Mapping>
+inline constexpr std::size_t chunkSize(const std::size_t grainSize)
+{
+	return roundUp(std::max<std::size_t>(grainSize, 1u), std::max(Mapping::granularity, Mapping::lanes));
+}
+
+} // namespace detail
+
+///
+/// Invokes \a function with views of consecutive chunks of \a vectors, distributed across \ref ThreadPool::instance.
+///
+/// Chunks hold about \a grainSize vectors and start at multiples of \ref detail::chunkSize, so the batch kernels can be applied to each of
+/// them. Chunks are disjoint, but \a function is invoked concurrently and has to synchronize access to any other shared state.
+///
+template <typename ValueType, std::size_t Order, typename Layout, typename Function>
+void parallelForEach(const VectorSoAView<ValueType, Order, Layout> vectors, const Function &function,
+					 const std::size_t grainSize = detail::parallelGrainSize)
+{
+	using Mapping = typename VectorSoAView<ValueType, Order, Layout>::Mapping;
+
+	const std::size_t chunkSize		= detail::chunkSize<Mapping>(grainSize);
+	const std::size_t chunkCount	= (vectors.size() + chunkSize - 1u) / chunkSize;
+
+	ThreadPool::instance().parallelFor(chunkCount, [vectors, &function, chunkSize](const std::size_t chunk)
+	{
+		const std::size_t index = chunk * chunkSize;
+		function(vectors.subview(index, std::min(chunkSize, vectors.size() - index)));
+	});
+}
+
+template <typename ValueType, std::size_t Order, typename Layout, typename Function>
+void parallelForEach(VectorSoA<ValueType, Order, Layout> &vectors, const Function &function, const std::size_t grainSize = detail::parallelGrainSize)
+{
+	parallelForEach(vectors.view(), function, grainSize);
+}
+
+template <typename ValueType, std::size_t Order, typename Layout, typename Function>
+void parallelForEach(const VectorSoA<ValueType, Order, Layout> &vectors, const Function &function,
+					 const std::size_t grainSize = detail::parallelGrainSize)
+{
+	parallelForEach(vectors.view(), function, grainSize);
+}
+
+///
+/// Invokes \a function with views of corresponding chunks of \a input and \a output, which have to have the same size, in parallel. For
+/// example, \c transformPoints can be passed as is through a lambda forwarding both chunks.
+///
+template <typename Input, typename ValueType, std::size_t InputOrder, std::size_t Order, typename Layout, typename Function>
+void parallelTransform(const VectorSoAView<Input, InputOrder, Layout> input, const VectorSoAView<ValueType, Order, Layout> output,
+					   const Function &function, const std::size_t grainSize = detail::parallelGrainSize)
+{
+	using Mapping = typename VectorSoAView<ValueType, Order, Layout>::Mapping;
+
+	assert(input.size() == output.size());
+
+	const std::size_t chunkSize		= detail::chunkSize<Mapping>(grainSize);
+	const std::size_t chunkCount	= (output.size() + chunkSize - 1u) / chunkSize;
+
+	ThreadPool::instance().parallelFor(chunkCount, [input, output, &function, chunkSize](const std::size_t chunk)
+	{
+		const std::size_t index = chunk * chunkSize;
+		const std::size_t count = std::min(chunkSize, output.size() - index);
+
+		function(input.subview(index, count), output.subview(index, count));
+	});
+}
+
+template <typename ValueType, std::size_t InputOrder, std::size_t Order, typename Layout, typename Function>
+void parallelTransform(const VectorSoA<ValueType, InputOrder, Layout> &input, VectorSoA<ValueType, Order, Layout> &output, const Function &function,
+					   const std::size_t grainSize = detail::parallelGrainSize)
+{
+	parallelTransform(input.view(), output.view(), function, grainSize);
+}
+
+///
+/// Maps every chunk of \a vectors to a partial result with \a map in parallel and combines the partial results with \a reduce, starting from
+/// \a identity.
+///
+/// Partial results are combined on the calling thread in the order of the chunks, so the result only depends on \a grainSize and not on
+/// the number of threads or the scheduling, which keeps floating point reductions reproducible.
+///
+template <typename ValueType, std::size_t Order, typename Layout, typename Result, typename Map, typename Reduce>
+Result parallelReduce(const VectorSoAView<ValueType, Order, Layout> vectors, Result identity, const Map &map, const Reduce &reduce,
+					  const std::size_t grainSize = detail::parallelGrainSize)
+{
+	using Mapping = typename VectorSoAView<ValueType, Order, Layout>::Mapping;
+
+	const std::size_t chunkSize		= detail::chunkSize<Mapping>(grainSize);
+	const std::size_t chunkCount	= (vectors.size() + chunkSize - 1u) / chunkSize;
+
+	std::vector<Result> partials(chunkCount, identity);
+
+	ThreadPool::instance().parallelFor(chunkCount, [vectors, &map, &partials, chunkSize](const std::size_t chunk)
+	{
+		const std::size_t index = chunk * chunkSize;
+		partials[chunk] = map(vectors.subview(index, std::min(chunkSize, vectors.size() - index)));
+	});
+
+	for (const Result &partial : partials)
+	{
+		identity = reduce(identity, partial);
+	}
+
+	return identity;
+}
+
+template <typename ValueType, std::size_t Order, typename Layout, typename Result, typename Map, typename Reduce>
+Result parallelReduce(const VectorSoA<ValueType, Order, Layout> &vectors, Result identity, const Map &map, const Reduce &reduce,
+					  const std::size_t grainSize = detail::parallelGrainSize)
+{
+	return parallelReduce(vectors.view(), std::move(identity), map, reduce, grainSize);
+}
+
+///
+/// Returns the \ref statistics of \a vectors, gathered in parallel by \ref parallelReduce.
+///
+template <typename ValueType, std::size_t Order, typename Layout>
+VectorStatistics<std::remove_const_t<ValueType>, Order> parallelStatistics(const VectorSoAView<ValueType, Order, Layout> vectors,
+																		   const std::size_t grainSize = detail::parallelGrainSize)
+{
+	using Statistics = VectorStatistics<std::remove_const_t<ValueType>, Order>;
+
+	return parallelReduce(vectors, Statistics{}, [](const VectorSoAView<ValueType, Order, Layout> chunk)
+	{
+		return statistics(chunk);
+	}, [](Statistics left, const Statistics &right)
+	{
+		return left.merge(right);
+	}, grainSize);
+}
+
+template <typename ValueType, std::size_t Order, typename Layout>
+VectorStatistics<ValueType, Order> parallelStatistics(const VectorSoA<ValueType, Order, Layout> &vectors,
+													  const std::size_t grainSize = detail::parallelGrainSize)
+{
+	return parallelStatistics(vectors.view(), grainSize);
+}
+
+// Short aliases
+template <typename T>
+using VectorSoA4 = VectorSoA<T, 4u>;
+
+template <typename T>
+using VectorSoA3 = VectorSoA<T, 3u>;
+
+template <typename T>
+using VectorSoA2 = VectorSoA<T, 2u>;
+
+using VectorSoA4_f		= VectorSoA4<float>;
+using VectorSoA3_f		= VectorSoA3<float>;
+using VectorSoA2_f		= VectorSoA2<float>;
+
+using VectorSoA4_d		= VectorSoA4<double>;
+using VectorSoA3_d		= VectorSoA3<double>;
+using VectorSoA2_d		= VectorSoA2<double>;
+
+///
+/// Vectors stored in blocks of one cache line per component.
+///
+template <typename T, std::size_t Order>
+using VectorAoSoA = VectorSoA<T, Order, layout::AoSoA<std::max<std::size_t>(simd::cacheLineSize / sizeof (T), 1u)>>;
+
+using VectorAoSoA4_f	= VectorAoSoA<float, 4u>;
+using VectorAoSoA3_f	= VectorAoSoA<float, 3u>;
+using VectorAoSoA2_f	= VectorAoSoA<float, 2u>;
+
+using VectorAoSoA4_d	= VectorAoSoA<double, 4u>;
+using VectorAoSoA3_d	= VectorAoSoA<double, 3u>;
+using VectorAoSoA2_d	= VectorAoSoA<double, 2u>;
+
+} // namespace nd::math
 
 #endif // ND_MATH_VECTOR_SOA_HPP
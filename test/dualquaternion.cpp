@@ -0,0 +1,332 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <dualquaternion.hpp>
+#include <matrix.hpp>
+#include <quaternion.hpp>
+#include <units.hpp>
+#include <vectorsoa.hpp>
+
+#include "numeric.hpp"
+#include "test.hpp"
+
+using namespace nd::math;
+
+template <typename ValueType>
+Vector3<ValueType> randomVector(std::mt19937 &generator)
+{
+	std::uniform_real_distribution<ValueType> distribution{ValueType(-4), ValueType(4)};
+
+	return Vector3<ValueType>{{distribution(generator), distribution(generator), distribution(generator)}};
+}
+
+template <typename ValueType, typename Layout>
+Vector3<ValueType> vertex(const VectorSoA<ValueType, 3u, Layout> &vertices, const std::size_t index)
+{
+	return ColumnVector3<ValueType>(vertices[index]).transposed();
+}
+
+template <typename ValueType>
+DualQuaternion<ValueType> randomTransformation(std::mt19937 &generator)
+{
+	return DualQuaternion<ValueType>{randomRotation<ValueType>(generator), randomVector<ValueType>(generator)};
+}
+
+///
+/// Reference blend of the bones of one vertex, flipping each bone onto the hemisphere of the first like the batch kernel.
+///
+template <typename ValueType, std::size_t Influences>
+DualQuaternion<ValueType> referenceBlend(const std::vector<DualQuaternion<ValueType>> &bones, const std::uint32_t (&indices)[Influences],
+										 const ValueType (&weights)[Influences])
+{
+	DualQuaternion<ValueType> returnValue;
+
+	for (std::size_t influence = 0u; influence < Influences; ++influence)
+	{
+		const DualQuaternion<ValueType> &bone = bones[indices[influence]];
+
+		const ValueType sign = (bone.real().dot(bones[indices[0u]].real()) < ValueType{}) ? ValueType(-1) : ValueType(1);
+		returnValue += bone * (sign * weights[influence]);
+	}
+
+	return returnValue.normalized();
+}
+
+template <typename ValueType>
+void testTransformation()
+{
+	constexpr ValueType tolerance = std::numeric_limits<ValueType>::epsilon() * ValueType(256);
+
+	std::mt19937 generator{15u};
+
+	for (std::size_t iteration = 0u; iteration < 100u; ++iteration)
+	{
+		const Quaternion<ValueType>	rotation	= randomTransformation<ValueType>(generator).rotation();
+		const Vector3<ValueType>	translation	= randomVector<ValueType>(generator);
+		const Vector3<ValueType>	point		= randomVector<ValueType>(generator);
+
+		const DualQuaternion<ValueType> transformation{rotation, translation};
+
+		assertNear(transformation.translation(), translation, tolerance);
+		assertNear(transformation.transformPoint(point), Vector3<ValueType>(rotation.rotate(point) + translation), tolerance);
+		assertNear(transformation.transformDirection(point), rotation.rotate(point), tolerance);
+
+		// The matrix applies the same transformation to homogeneous column vectors
+		const ColumnVector4<ValueType>	homogeneous{{point[0u], point[1u], point[2u], ValueType(1)}};
+		const ColumnVector4<ValueType>	transformed	= transformation.toTransformationMatrix() * homogeneous;
+		const Vector3<ValueType>		expected	= transformation.transformPoint(point);
+
+		for (std::size_t index = 0u; index < 3u; ++index)
+		{
+			assertNear(transformed[index], expected[index], tolerance);
+		}
+
+		assertNear(transformed[3u], ValueType(1), tolerance);
+
+		// Composition applies the right hand side first, the conjugate undoes the transformation
+		const DualQuaternion<ValueType> other = randomTransformation<ValueType>(generator);
+
+		assertNear((transformation * other).transformPoint(point), transformation.transformPoint(other.transformPoint(point)), tolerance);
+		assertNear((transformation.inverted() * transformation).transformPoint(point), point, tolerance);
+		assertNear(transformation.inverted() * transformation, DualQuaternion<ValueType>{traits::initialization::identity}, tolerance);
+
+		// Normalization removes a scale and the component of the dual part along the real part
+		DualQuaternion<ValueType> scaled = transformation * ValueType(3);
+		scaled.dual() += transformation.real() * ValueType(0.25);
+
+		assertNear(scaled.normalized(), transformation, tolerance);
+	}
+
+	const DualQuaternion<ValueType> identity{traits::initialization::identity};
+	const Vector3<ValueType>		point{{ValueType(1), ValueType(2), ValueType(3)}};
+
+	assertEqual(identity.transformPoint(point), point);
+	assertEqual(identity.translation(), Vector3<ValueType>{traits::initialization::zero});
+}
+
+///
+/// Checks the batch skinning against the reference blend on views starting in the middle of a register.
+///
+template <typename ValueType, typename Layout>
+void testSkinning()
+{
+	constexpr ValueType tolerance = std::numeric_limits<ValueType>::epsilon() * ValueType(256);
+
+	constexpr std::size_t influences	= 4u;
+	constexpr std::size_t boneCount		= 16u;
+	constexpr std::size_t size			= 203u;
+	constexpr std::size_t offset		= 3u;
+	constexpr std::size_t count			= 197u;
+
+	std::mt19937								generator{16u};
+	std::uniform_int_distribution<std::uint32_t>	boneDistribution{0u, boneCount - 1u};
+	std::uniform_real_distribution<ValueType>		weightDistribution{ValueType(0.05), ValueType(1)};
+
+	std::vector<DualQuaternion<ValueType>> bones;
+
+	for (std::size_t bone = 0u; bone < boneCount; ++bone)
+	{
+		bones.emplace_back(randomTransformation<ValueType>(generator));
+	}
+
+	VectorSoA<std::uint32_t, influences, Layout>	indices;
+	VectorSoA<ValueType, influences, Layout>		weights;
+	VectorSoA<ValueType, 3u, Layout>				points;
+
+	for (std::size_t index = 0u; index < size; ++index)
+	{
+		const ValueType weight[influences] = {weightDistribution(generator), weightDistribution(generator), weightDistribution(generator),
+											  weightDistribution(generator)};
+		const ValueType sum = weight[0u] + weight[1u] + weight[2u] + weight[3u];
+
+		indices.emplace_back(boneDistribution(generator), boneDistribution(generator), boneDistribution(generator), boneDistribution(generator));
+		weights.emplace_back(weight[0u] / sum, weight[1u] / sum, weight[2u] / sum, weight[3u] / sum);
+		points.push_back(randomVector<ValueType>(generator));
+	}
+
+	VectorSoA<ValueType, 3u, Layout> skinned	= points.clone();
+	VectorSoA<ValueType, 3u, Layout> rotated	= points.clone();
+
+	skinPoints(std::span<const DualQuaternion<ValueType>>{bones}, indices.view(offset, count), weights.view(offset, count),
+			   points.view(offset, count), skinned.view(offset, count));
+	skinDirections(std::span<const DualQuaternion<ValueType>>{bones}, indices.view(offset, count), weights.view(offset, count),
+				   points.view(offset, count), rotated.view(offset, count));
+
+	for (std::size_t index = 0u; index < size; ++index)
+	{
+		const Vector3<ValueType> point = vertex(points, index);
+
+		if ((index < offset) | (index >= (offset + count)))
+		{
+			assertEqual(vertex(skinned, index), point);
+			continue;
+		}
+
+		std::uint32_t	boneIndices[influences];
+		ValueType		boneWeights[influences];
+
+		for (std::size_t influence = 0u; influence < influences; ++influence)
+		{
+			boneIndices[influence] = *indices.data(influence, index);
+			boneWeights[influence] = *weights.data(influence, index);
+		}
+
+		const DualQuaternion<ValueType> blend = referenceBlend(bones, boneIndices, boneWeights);
+
+		assertNear(vertex(skinned, index), blend.transformPoint(point), tolerance);
+		assertNear(vertex(rotated, index), blend.transformDirection(point), tolerance);
+	}
+
+	// A single influence applies its bone exactly, in place over whole containers
+	VectorSoA<std::uint32_t, 1u, Layout>	single;
+	VectorSoA<ValueType, 1u, Layout>		ones;
+
+	for (std::size_t index = 0u; index < size; ++index)
+	{
+		single.emplace_back(std::uint32_t(index % boneCount));
+		ones.emplace_back(ValueType(1));
+	}
+
+	VectorSoA<ValueType, 3u, Layout> transformed = points.clone();
+	skinPoints(std::span<const DualQuaternion<ValueType>>{bones}, single, ones, transformed, transformed);
+
+	for (std::size_t index = 0u; index < size; ++index)
+	{
+		const Vector3<ValueType> expected = bones[index % boneCount].transformPoint(vertex(points, index));
+
+		assertNear(vertex(transformed, index), expected, tolerance);
+	}
+}
+
+///
+/// Blends two bones twisted by a sixth of a turn either way about the same axis: the dual quaternion blend keeps the point at its distance from
+/// the axis, while blending the matrices collapses it towards the axis.
+///
+template <typename ValueType>
+void testJoint()
+{
+	constexpr ValueType tolerance = std::numeric_limits<ValueType>::epsilon() * ValueType(64);
+
+	const Vector3<ValueType> axis{{ValueType(1), ValueType(0), ValueType(0)}};
+	const Vector3<ValueType> zero{traits::initialization::zero};
+
+	const std::vector<DualQuaternion<ValueType>> bones{
+		DualQuaternion<ValueType>{Quaternion<ValueType>{units::Radians<ValueType>{ValueType(M_PI / 3.0)}, axis}, zero},
+		DualQuaternion<ValueType>{Quaternion<ValueType>{units::Radians<ValueType>{ValueType(-M_PI / 3.0)}, axis}, zero}};
+
+	VectorSoA<std::uint32_t, 2u>	indices;
+	VectorSoA<ValueType, 2u>		weights;
+	VectorSoA<ValueType, 3u>		points;
+
+	indices.emplace_back(0u, 1u);
+	weights.emplace_back(ValueType(0.5), ValueType(0.5));
+	points.emplace_back(ValueType(2), ValueType(1), ValueType(0));
+
+	VectorSoA<ValueType, 3u> skinned(1u);
+	skinPoints(std::span<const DualQuaternion<ValueType>>{bones}, indices, weights, points, skinned);
+
+	const Vector3<ValueType> expected{{ValueType(2), ValueType(1), ValueType(0)}};
+	assertNear(vertex(skinned, 0u), expected, tolerance);
+
+	const Matrix4x4<ValueType>		blended		= bones[0u].toTransformationMatrix() * ValueType(0.5) + bones[1u].toTransformationMatrix() * ValueType(0.5);
+	const ColumnVector4<ValueType>	collapsed	= blended * ColumnVector4<ValueType>{{ValueType(2), ValueType(1), ValueType(0), ValueType(1)}};
+
+	assertNear(collapsed[1u], ValueType(0.5), tolerance);
+}
+
+int main(int, char **)
+{
+	testTransformation<float>();
+	testTransformation<double>();
+
+	testSkinning<float, layout::SoA>();
+	testSkinning<double, layout::SoA>();
+	testSkinning<float, layout::AoSoA<8u>>();
+
+	testJoint<float>();
+	testJoint<double>();
+
+	{
+		// A hundred thousand vertices of a skeleton with 64 bones, four influences each
+		constexpr std::size_t count			= 100000u;
+		constexpr std::size_t influences	= 4u;
+		constexpr std::size_t boneCount		= 64u;
+		constexpr std::size_t iterations	= 100u;
+
+		std::mt19937								generator{17u};
+		std::uniform_int_distribution<std::uint32_t>	boneDistribution{0u, boneCount - 1u};
+
+		std::vector<DualQuaternion_f> bones;
+		std::vector<Matrix4x4_f> palette;
+
+		for (std::size_t bone = 0u; bone < boneCount; ++bone)
+		{
+			bones.emplace_back(randomTransformation<float>(generator));
+			palette.push_back(bones.back().toTransformationMatrix());
+		}
+
+		VectorSoA<std::uint32_t, influences>	indices;
+		VectorSoA<float, influences>			weights;
+		VectorSoA<float, 3u>					points;
+
+		for (std::size_t index = 0u; index < count; ++index)
+		{
+			indices.emplace_back(boneDistribution(generator), boneDistribution(generator), boneDistribution(generator), boneDistribution(generator));
+			weights.emplace_back(0.4f, 0.3f, 0.2f, 0.1f);
+			points.push_back(randomVector<float>(generator));
+		}
+
+		VectorSoA<float, 3u> skinned(count);
+
+		std::chrono::duration<double> actualDuration;
+		benchmark(iterations, actualDuration, [&palette, &indices, &weights, &points, &skinned]()
+		{
+			for (std::size_t index = 0u; index < count; ++index)
+			{
+				float blended[12u] = {};
+
+				for (std::size_t influence = 0u; influence < influences; ++influence)
+				{
+					const float *matrix	= palette[*indices.data(influence, index)].data();
+					const float weight	= *weights.data(influence, index);
+
+					for (std::size_t entry = 0u; entry < 12u; ++entry)
+					{
+						blended[entry] += matrix[entry] * weight;
+					}
+				}
+
+				const float x = *points.data(0u, index);
+				const float y = *points.data(1u, index);
+				const float z = *points.data(2u, index);
+
+				for (std::size_t row = 0u; row < 3u; ++row)
+				{
+					*skinned.data(row, index) = blended[row * 4u] * x + blended[row * 4u + 1u] * y + blended[row * 4u + 2u] * z + blended[row * 4u + 3u];
+				}
+			}
+		});
+
+		std::cout << count << " vertices skinned by matrix palette in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		benchmark(iterations, actualDuration, [&bones, &indices, &weights, &points, &skinned]()
+		{
+			skinPoints(std::span<const DualQuaternion_f>{bones}, indices, weights, points, skinned);
+		});
+
+		std::cout << count << " vertices skinned by dual quaternions in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+	}
+
+	return EXIT_SUCCESS;
+}
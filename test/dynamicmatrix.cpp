@@ -0,0 +1,101 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <utility>
+
+#include <dynamicmatrix.hpp>
+#include <matrix.hpp>
+
+#include "test.hpp"
+
+using namespace nd::math;
+
+constexpr std::size_t matrixOrder = 512u;
+
+int main(int, char **)
+{
+	{
+		constexpr std::size_t	iterations	= 5u;
+		const DynamicMatrix_f	matrix0{matrixOrder, matrixOrder, traits::initialization::zero};
+		const DynamicMatrix_f	matrix1{matrixOrder, matrixOrder, traits::initialization::identity};
+		DynamicMatrix_f			matrix2{matrixOrder, matrixOrder};
+
+		std::chrono::duration<double> actualDuration;
+		benchmark(iterations, actualDuration, [&matrix0, &matrix1, &matrix2]()
+		{
+			mul(matrix2, matrix0, matrix1);
+		});
+
+		const double seconds	= std::chrono::duration_cast<std::chrono::milliseconds>(actualDuration).count() / 1000.0;
+		const double flop		= std::pow(double(matrixOrder), 3.0);
+		const double gflops		= (double(iterations) / seconds * flop / 1.0E9);
+
+		std::cout << iterations << " runs performed " << std::to_string(seconds) << " s " << std::to_string(gflops) << " GFLOPS\n";
+	}
+
+	{
+		// Runtime sized products match the fixed size ones, including on views of fixed size matrices
+		constexpr std::size_t l = 37u;
+		constexpr std::size_t m = 53u;
+		constexpr std::size_t n = 29u;
+
+		const std::unique_ptr<Matrix<double, l, m>>	left		= std::make_unique<Matrix<double, l, m>>();
+		const std::unique_ptr<Matrix<double, m, n>>	right		= std::make_unique<Matrix<double, m, n>>();
+		std::unique_ptr<Matrix<double, l, n>>		expected	= std::make_unique<Matrix<double, l, n>>();
+		std::unique_ptr<Matrix<double, l, n>>		viewed		= std::make_unique<Matrix<double, l, n>>();
+
+		for (std::size_t index = 0u; index < l * m; ++index)
+		{
+			left->data()[index] = double(index % 7u) - 3.0;
+		}
+
+		for (std::size_t index = 0u; index < m * n; ++index)
+		{
+			right->data()[index] = double(index % 5u) - 2.0;
+		}
+
+		mul(*expected, *left, *right);
+
+		const DynamicMatrix_d	dynamicLeft{*left};
+		const DynamicMatrix_d	dynamicRight{*right};
+		DynamicMatrix_d			dynamicResult = dynamicLeft * dynamicRight;
+
+		assertEqual(dynamicResult, DynamicMatrix_d{*expected});
+
+		mul(view(*viewed), view(*left), dynamicRight.view());
+
+		assertEqual(*viewed, *expected);
+
+		mul(execution::par, dynamicResult, dynamicLeft, dynamicRight);
+
+		assertEqual(dynamicResult, DynamicMatrix_d{*expected});
+
+		// Fused update reading both operands transposed: C = 2 (B^T A^T)^T - C
+		const DynamicMatrix_d leftTransposed{left->transposed()};
+		const DynamicMatrix_d rightTransposed{right->transposed()};
+
+		gemm(2.0, leftTransposed.view(), Transposition::transpose, rightTransposed.view(), Transposition::transpose, -1.0, dynamicResult.view());
+
+		assertEqual(dynamicResult, DynamicMatrix_d{*expected});
+	}
+
+	{
+		DynamicMatrix_f			matrix0{3u, 3u, traits::initialization::identity};
+		const DynamicMatrix_f	matrix1 = matrix0.clone();
+
+		matrix0 += matrix1;
+		matrix0 *= 2.0f;
+		matrix0 -= matrix1;
+
+		DynamicMatrix_f matrix2 = std::move(matrix0);
+
+		assertEqual(matrix0.size(), std::size_t{0u});
+		assertEqual(matrix2, DynamicMatrix_f{Matrix3x3_f{{3, 0, 0, 0, 3, 0, 0, 0, 3}}});
+
+		std::cout << matrix2 << "\n";
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -1,11 +1,20 @@
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 #include <matrix.hpp>
+#include <strassen.hpp>
 
+#include "numeric.hpp"
 #include "test.hpp"
 
 using namespace nd::math;
@@ -13,6 +22,190 @@ using namespace nd::math;
 constexpr std::size_t matrixOrder = 512u;
 using MatrixType = Matrix<float, matrixOrder, matrixOrder>;
 
+template <typename ValueType, std::size_t L, std::size_t M, std::size_t N>
+void referenceMul(Matrix<ValueType, L, N> &result, const Matrix<ValueType, L, M> &left, const Matrix<ValueType, M, N> &right)
+{
+	result.setZero();
+
+	for (std::size_t i = 0u; i < L; ++i)
+	{
+		for (std::size_t k = 0u; k < M; ++k)
+		{
+			for (std::size_t j = 0u; j < N; ++j)
+			{
+				result.data()[i * N + j] += left.data()[i * M + k] * right.data()[k * N + j];
+			}
+		}
+	}
+}
+
+///
+/// Checks $C \leftarrow \alpha\,op(A)\,op(B) + \beta C$ for all transposition combinations against explicitly transposed products.
+///
+template <typename ValueType, std::size_t L, std::size_t M, std::size_t N>
+void testGemm()
+{
+	const std::unique_ptr<Matrix<ValueType, L, M>>	left		= std::make_unique<Matrix<ValueType, L, M>>();
+	const std::unique_ptr<Matrix<ValueType, M, N>>	right		= std::make_unique<Matrix<ValueType, M, N>>();
+	const std::unique_ptr<Matrix<ValueType, L, N>>	initial		= std::make_unique<Matrix<ValueType, L, N>>();
+	std::unique_ptr<Matrix<ValueType, L, N>>		expected	= std::make_unique<Matrix<ValueType, L, N>>();
+	std::unique_ptr<Matrix<ValueType, L, N>>		actual		= std::make_unique<Matrix<ValueType, L, N>>();
+
+	for (std::size_t index = 0u; index < L * M; ++index)
+	{
+		left->data()[index] = ValueType(index % 7u) - ValueType(3);
+	}
+
+	for (std::size_t index = 0u; index < M * N; ++index)
+	{
+		right->data()[index] = ValueType(index % 5u) - ValueType(2);
+	}
+
+	for (std::size_t index = 0u; index < L * N; ++index)
+	{
+		initial->data()[index] = ValueType(index % 3u);
+	}
+
+	// Small integers keep every partial sum exact, so the results must match bit for bit
+	referenceMul(*expected, *left, *right);
+
+	for (std::size_t index = 0u; index < L * N; ++index)
+	{
+		expected->data()[index] = ValueType(2) * expected->data()[index] - initial->data()[index];
+	}
+
+	const std::unique_ptr<Matrix<ValueType, M, L>> leftTransposed	= std::make_unique<Matrix<ValueType, M, L>>(left->transposed());
+	const std::unique_ptr<Matrix<ValueType, N, M>> rightTransposed	= std::make_unique<Matrix<ValueType, N, M>>(right->transposed());
+
+	*actual = *initial;
+	gemm(ValueType(2), *left, *right, ValueType(-1), *actual);
+	assertEqual(*actual, *expected);
+
+	*actual = *initial;
+	gemm<Transposition::transpose>(ValueType(2), *leftTransposed, *right, ValueType(-1), *actual);
+	assertEqual(*actual, *expected);
+
+	*actual = *initial;
+	gemm<Transposition::none, Transposition::transpose>(ValueType(2), *left, *rightTransposed, ValueType(-1), *actual);
+	assertEqual(*actual, *expected);
+
+	*actual = *initial;
+	gemm<Transposition::transpose, Transposition::transpose>(execution::par, ValueType(2), *leftTransposed, *rightTransposed, ValueType(-1), *actual);
+	assertEqual(*actual, *expected);
+
+	// A zero beta overwrites the result without reading it
+	referenceMul(*expected, *left, *right);
+
+	actual->setZero();
+	*actual /= ValueType(0);
+	gemm(ValueType(1), *left, *right, ValueType(0), *actual);
+	assertEqual(*actual, *expected);
+}
+
+///
+/// Checks inverse, determinant and solve of a diagonally dominant matrix whose rows are rotated, so partial pivoting has to swap rows.
+///
+template <typename ValueType, std::size_t Order>
+void testInverse()
+{
+	constexpr ValueType tolerance = std::numeric_limits<ValueType>::epsilon() * ValueType(64);
+
+	Matrix<ValueType, Order, Order>	matrix;
+	Matrix<ValueType, Order, 2u>	rhs;
+
+	for (std::size_t i = 0u; i < Order; ++i)
+	{
+		for (std::size_t j = 0u; j < Order; ++j)
+		{
+			matrix[(i + 1u) % Order][j] = (i == j) ? ValueType(4 * Order) : ValueType(int((i * 7u + j * 3u) % 5u) - 2);
+		}
+
+		rhs[i][0u] = ValueType(i) - ValueType(1);
+		rhs[i][1u] = ValueType(2);
+	}
+
+	const Matrix<ValueType, Order, Order> identity{traits::initialization::identity};
+
+	assertNear(matrix * matrix.inverted(), identity, tolerance);
+	assertNear(matrix * matrix.solve(rhs), rhs, tolerance * ValueType(Order));
+
+	// The determinant is multiplicative and flips its sign with every row swap
+	const Matrix<ValueType, Order, Order> product = matrix * matrix.transposed();
+	assertNear(product.determinant() / (matrix.determinant() * matrix.determinant()), ValueType(1), tolerance * ValueType(Order));
+	assertNear(matrix.inverted().determinant() * matrix.determinant(), ValueType(1), tolerance * ValueType(Order));
+
+	Matrix<ValueType, Order, Order> swapped = matrix;
+
+	for (std::size_t j = 0u; j < Order; ++j)
+	{
+		std::swap(swapped[0u][j], swapped[1u][j]);
+	}
+
+	assertEqual(swapped.determinant(), -matrix.determinant());
+}
+
+template <typename ValueType, std::size_t Rows, std::size_t Columns>
+void testTranspose()
+{
+	const std::unique_ptr<Matrix<ValueType, Rows, Columns>>	matrix		= std::make_unique<Matrix<ValueType, Rows, Columns>>();
+	std::unique_ptr<Matrix<ValueType, Columns, Rows>>		transposed	= std::make_unique<Matrix<ValueType, Columns, Rows>>();
+
+	for (std::size_t index = 0u; index < Rows * Columns; ++index)
+	{
+		matrix->data()[index] = ValueType(index % 1000u);
+	}
+
+	*transposed = matrix->transposed();
+
+	for (std::size_t i = 0u; i < Rows; ++i)
+	{
+		for (std::size_t j = 0u; j < Columns; ++j)
+		{
+			assertEqual(transposed->data()[j * Rows + i], matrix->data()[i * Columns + j]);
+		}
+	}
+
+	if constexpr (Rows == Columns)
+	{
+		std::unique_ptr<Matrix<ValueType, Rows, Columns>> inPlace = std::make_unique<Matrix<ValueType, Rows, Columns>>(*matrix);
+
+		inPlace->transpose();
+		assertEqual(*inPlace, *transposed);
+
+		inPlace->transpose();
+		assertEqual(*inPlace, *matrix);
+	}
+}
+
+template <typename ValueType>
+void testProducts4()
+{
+	constexpr std::array<ValueType, 16u>	leftValues		= {1, 2, 3, 4, -5, 6, 7, 8, 9, 10, -11, 12, 13, 14, 15, -16};
+	constexpr std::array<ValueType, 16u>	rightValues		= {2, 0, 1, 3, 1, -1, 4, 0, 0, 5, 2, 1, 3, 1, 0, -2};
+	constexpr std::array<ValueType, 4u>		vectorValues	= {1, -2, 3, 4};
+
+	const Matrix4x4<ValueType>		left{leftValues};
+	const Matrix4x4<ValueType>		right{rightValues};
+	const ColumnVector4<ValueType>	columnVector{vectorValues};
+	const Vector4<ValueType>		vector{vectorValues};
+
+	Matrix4x4<ValueType>		expectedMatrix;
+	ColumnVector4<ValueType>	expectedColumnVector;
+	Vector4<ValueType>			expectedVector;
+
+	referenceMul(expectedMatrix, left, right);
+	referenceMul(expectedColumnVector, left, columnVector);
+	referenceMul(expectedVector, vector, right);
+
+	assertEqual(left * right, expectedMatrix);
+	assertEqual(left * columnVector, expectedColumnVector);
+	assertEqual(vector * right, expectedVector);
+
+	// The scalar path stays available for constant evaluation
+	constexpr ValueType element = (Matrix4x4<ValueType>{leftValues} * Matrix4x4<ValueType>{rightValues})[1u][2u];
+	assertEqual(element, expectedMatrix[1u][2u]);
+}
+
 int main(int, char **)
 {
 	{
@@ -34,6 +227,328 @@ int main(int, char **)
 		std::cout << iterations << " runs performed " << std::to_string(seconds) << " s " << std::to_string(gflops) << " GFLOPS\n";
 	}
 
+	{
+		constexpr std::size_t				iterations	= 5u;
+		const std::unique_ptr<MatrixType>	matrix0		= std::make_unique<MatrixType>(traits::initialization::zero);
+		const std::unique_ptr<MatrixType>	matrix1		= std::make_unique<MatrixType>(traits::initialization::identity);
+		std::unique_ptr<MatrixType>			matrix2		= std::make_unique<MatrixType>(traits::initialization::zero);
+
+		std::chrono::duration<double> actualDuration;
+		benchmark(iterations, actualDuration, [&matrix0, &matrix1, &matrix2]()
+		{
+			mul(execution::par, *matrix2, *matrix0, *matrix1);
+		});
+
+		const double seconds	= std::chrono::duration_cast<std::chrono::milliseconds>(actualDuration).count() / 1000.0;
+		const double flop		= std::pow(double(matrixOrder), 3.0);
+		const double gflops		= (double(iterations) / seconds * flop / 1.0E9);
+
+		std::cout << iterations << " parallel runs performed on " << ThreadPool::instance().concurrency() << " threads "
+				  << std::to_string(seconds) << " s " << std::to_string(gflops) << " GFLOPS\n";
+	}
+
+	{
+		constexpr std::size_t				iterations	= 5u;
+		const std::unique_ptr<MatrixType>	matrix0		= std::make_unique<MatrixType>(traits::initialization::zero);
+		const std::unique_ptr<MatrixType>	matrix1		= std::make_unique<MatrixType>(traits::initialization::identity);
+		std::unique_ptr<MatrixType>			matrix2		= std::make_unique<MatrixType>(traits::initialization::zero);
+
+		std::chrono::duration<double> actualDuration;
+		benchmark(iterations, actualDuration, [&matrix0, &matrix1, &matrix2]()
+		{
+			mulStrassen(*matrix2, *matrix0, *matrix1);
+		});
+
+		const double seconds	= std::chrono::duration_cast<std::chrono::milliseconds>(actualDuration).count() / 1000.0;
+		const double flop		= std::pow(double(matrixOrder), 3.0);
+		const double gflops		= (double(iterations) / seconds * flop / 1.0E9);
+
+		std::cout << iterations << " Strassen-Winograd runs performed " << std::to_string(seconds) << " s " << std::to_string(gflops)
+				  << " effective GFLOPS\n";
+	}
+
+	{
+		// Strassen-Winograd with several levels of recursion and peeled odd orders; small integers keep every partial sum exact
+		constexpr std::size_t order = 203u;
+
+		const std::unique_ptr<Matrix<double, order, order>>	left		= std::make_unique<Matrix<double, order, order>>();
+		const std::unique_ptr<Matrix<double, order, order>>	right		= std::make_unique<Matrix<double, order, order>>();
+		std::unique_ptr<Matrix<double, order, order>>		actual		= std::make_unique<Matrix<double, order, order>>();
+		std::unique_ptr<Matrix<double, order, order>>		expected	= std::make_unique<Matrix<double, order, order>>();
+
+		for (std::size_t index = 0u; index < order * order; ++index)
+		{
+			left->data()[index]		= double(index % 7u) - 3.0;
+			right->data()[index]	= double(index % 5u) - 2.0;
+		}
+
+		referenceMul(*expected, *left, *right);
+
+		mulStrassen(*actual, *left, *right, 24u);
+		assertEqual(*actual, *expected);
+
+		DynamicMatrix_d dynamicResult{order, order};
+		mulStrassen(dynamicResult, DynamicMatrix_d{*left}, DynamicMatrix_d{*right}, 50u);
+		assertEqual(dynamicResult, DynamicMatrix_d{*expected});
+	}
+
+	{
+		// Odd orders exercise the edge tiles of the blocked kernel
+		constexpr std::size_t l = 67u;
+		constexpr std::size_t m = 131u;
+		constexpr std::size_t n = 45u;
+
+		const std::unique_ptr<Matrix<float, l, m>>	left		= std::make_unique<Matrix<float, l, m>>();
+		const std::unique_ptr<Matrix<float, m, n>>	right		= std::make_unique<Matrix<float, m, n>>();
+		std::unique_ptr<Matrix<float, l, n>>		actual		= std::make_unique<Matrix<float, l, n>>();
+		std::unique_ptr<Matrix<float, l, n>>		expected	= std::make_unique<Matrix<float, l, n>>();
+
+		for (std::size_t index = 0u; index < l * m; ++index)
+		{
+			left->data()[index] = float(index % 7u) - 3.0f;
+		}
+
+		for (std::size_t index = 0u; index < m * n; ++index)
+		{
+			right->data()[index] = float(index % 5u) - 2.0f;
+		}
+
+		referenceMul(*expected, *left, *right);
+
+		mul(*actual, *left, *right);
+
+		assertEqual(*actual, *expected);
+	}
+
+	{
+		// Parallel tiling against the serial kernel, on a dedicated pool so tiles really run on several threads
+		constexpr std::size_t l = 301u;
+		constexpr std::size_t m = 157u;
+		constexpr std::size_t n = 263u;
+
+		const std::unique_ptr<Matrix<float, l, m>>	left		= std::make_unique<Matrix<float, l, m>>();
+		const std::unique_ptr<Matrix<float, m, n>>	right		= std::make_unique<Matrix<float, m, n>>();
+		std::unique_ptr<Matrix<float, l, n>>		actual		= std::make_unique<Matrix<float, l, n>>(traits::initialization::zero);
+		std::unique_ptr<Matrix<float, l, n>>		expected	= std::make_unique<Matrix<float, l, n>>();
+
+		for (std::size_t index = 0u; index < l * m; ++index)
+		{
+			left->data()[index] = float(index % 7u) - 3.0f;
+		}
+
+		for (std::size_t index = 0u; index < m * n; ++index)
+		{
+			right->data()[index] = float(index % 5u) - 2.0f;
+		}
+
+		referenceMul(*expected, *left, *right);
+
+		using Blocking = detail::GemmBlocking<float, l, m, n>;
+		ThreadPool pool{3u};
+		detail::gemmParallel<Blocking>(pool, l, n, m, left->data(), m, right->data(), n, actual->data(), n);
+
+		assertEqual(*actual, *expected);
+
+		mul(execution::par, *actual, *left, *right);
+
+		assertEqual(*actual, *expected);
+	}
+
+	{
+		// An exception thrown by one invocation reaches the caller only after every other invocation has finished
+		ThreadPool					pool{3u};
+		std::atomic<std::size_t>	invocations	= 0u;
+		bool						caught		= false;
+
+		try
+		{
+			pool.parallelFor(64u, [&invocations](const std::size_t index)
+			{
+				invocations.fetch_add(1u, std::memory_order_relaxed);
+
+				if (index == 13u)
+				{
+					throw std::runtime_error{"task failed"};
+				}
+			});
+		}
+		catch (const std::runtime_error &)
+		{
+			caught = true;
+		}
+
+		assertEqual(caught, true);
+		assertEqual(invocations.load(), std::size_t{64u});
+
+		// The pool stays usable afterwards
+		invocations = 0u;
+		pool.parallelFor(64u, [&invocations](const std::size_t)
+		{
+			invocations.fetch_add(1u, std::memory_order_relaxed);
+		});
+
+		assertEqual(invocations.load(), std::size_t{64u});
+	}
+
+	// Fused products with scaling and transposed operands, on the reference loop and on the blocked kernel
+	testGemm<float, 5u, 3u, 7u>();
+	testGemm<double, 5u, 3u, 7u>();
+	testGemm<float, 67u, 131u, 45u>();
+	testGemm<double, 150u, 140u, 130u>();
+
+	{
+		constexpr float element = []()
+		{
+			const Matrix3x3_f	left{{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f}};
+			Matrix3x3_f			result{traits::initialization::identity};
+			gemm<Transposition::transpose>(1.0f, left, left, 2.0f, result);
+			return result[1u][1u];
+		}();
+
+		static_assert(element == 2.0f + 4.0f + 25.0f + 64.0f);
+	}
+
+	// Register tiled transposes including edge tiles, out of place and in place
+	testTranspose<float, 67u, 131u>();
+	testTranspose<float, 8u, 8u>();
+	testTranspose<float, 131u, 131u>();
+	testTranspose<double, 37u, 53u>();
+	testTranspose<double, 70u, 70u>();
+	testTranspose<std::int32_t, 9u, 13u>();
+	testTranspose<std::int32_t, 45u, 45u>();
+	testTranspose<float, 3u, 3u>();
+
+	// Subscripts of constant matrices refer to constant elements
+	static_assert(std::is_same_v<decltype (std::declval<const Vector3_f &>()[0u]), const float &>);
+	static_assert(std::is_same_v<decltype (std::declval<const Matrix3x3_f &>()[0u][0u]), const float &>);
+
+	{
+		static_assert(Matrix2x2_i32{{1, 2, 3, 4}}.transpose()[0u][1u] == 3);
+
+		constexpr std::size_t				iterations	= 100u;
+		const std::unique_ptr<MatrixType>	matrix		= std::make_unique<MatrixType>(traits::initialization::identity);
+		std::unique_ptr<MatrixType>			transposed	= std::make_unique<MatrixType>();
+
+		std::chrono::duration<double> actualDuration;
+		benchmark(iterations, actualDuration, [&matrix, &transposed]()
+		{
+			*transposed = matrix->transposed();
+		});
+
+		std::cout << iterations << " transposes " << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations)
+				  << " us\n";
+
+		benchmark(iterations, actualDuration, [&transposed]()
+		{
+			transposed->transpose();
+		});
+
+		std::cout << iterations << " in-place transposes " << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations)
+				  << " us\n";
+	}
+
+	// Closed-form inverses and the LU factorization
+	testInverse<float, 2u>();
+	testInverse<float, 3u>();
+	testInverse<float, 4u>();
+	testInverse<double, 4u>();
+	testInverse<double, 5u>();
+	testInverse<double, 11u>();
+
+	{
+		// A vanishing pivot fills the whole result with NaN instead of solving with a partial factorization
+		Matrix<double, 5u, 5u>	singular;
+		Matrix<float, 7u, 7u>	singularSystem;
+		Matrix<float, 7u, 2u>	rhs{traits::initialization::zero};
+
+		for (std::size_t i = 0u; i < 7u; ++i)
+		{
+			for (std::size_t j = 0u; j < 7u; ++j)
+			{
+				const int element = (j == 2u) ? 0 : int((i * 7u + j * 3u) % 5u) - 2 + ((i == j) ? 10 : 0);
+
+				singularSystem[i][j] = float(element);
+
+				if ((i < 5u) & (j < 5u))
+				{
+					singular[i][j] = double(element);
+				}
+			}
+		}
+
+		const Matrix<double, 5u, 5u>	inverse		= singular.inverted();
+		const Matrix<float, 7u, 2u>		solution	= singularSystem.solve(rhs);
+
+		assertEqual(std::all_of(inverse.data(), inverse.data() + 25u, [](const double element) { return std::isnan(element); }), true);
+		assertEqual(std::all_of(solution.data(), solution.data() + 14u, [](const float element) { return std::isnan(element); }), true);
+	}
+
+	{
+		static_assert(Matrix3x3_i32{{2, 0, 1, 1, 3, 2, 1, 1, 2}}.determinant() == 6);
+		static_assert(Matrix<std::int32_t, 5u, 5u>{traits::initialization::identity}.determinant() == 1);
+
+		// Integer determinants of larger orders are exact, also when the leading pivot vanishes or the matrix is singular
+		constexpr Matrix<std::int32_t, 5u, 5u> integers{{0, 2, 1, 0, 3, 1, 0, 0, 2, 1, 3, 1, 4, 1, 5, 2, 7, 1, 8, 2, 1, 1, 1, 1, 0}};
+		const Matrix<double, 5u, 5u> reals{{0, 2, 1, 0, 3, 1, 0, 0, 2, 1, 3, 1, 4, 1, 5, 2, 7, 1, 8, 2, 1, 1, 1, 1, 0}};
+
+		assertEqual(integers.determinant(), std::int32_t(std::lround(reals.determinant())));
+		static_assert(Matrix<std::int32_t, 5u, 5u>{{1, 2, 3, 4, 5, 2, 4, 6, 8, 10, 0, 1, 0, 1, 0, 3, 1, 4, 1, 5, 9, 2, 6, 5, 3}}.determinant() == 0);
+		static_assert(Matrix2x2_d{{4.0, 7.0, 2.0, 6.0}}.inverted()[1u][0u] == -0.2);
+		static_assert(Matrix<double, 5u, 5u>{traits::initialization::identity}.determinant() == 1.0);
+
+		constexpr std::size_t					count		= 4096u;
+		constexpr std::size_t					iterations	= 1000u;
+		const std::unique_ptr<Matrix4x4_f[]>	matrices	= std::make_unique<Matrix4x4_f[]>(count);
+		const std::unique_ptr<Matrix4x4_f[]>	inverses	= std::make_unique<Matrix4x4_f[]>(count);
+
+		for (std::size_t index = 0u; index < count; ++index)
+		{
+			matrices[index] = Matrix4x4_f{{2.0f + float(index % 3u), 0.0f, 0.0f, 1.0f, 0.0f, 2.0f, 0.0f, 2.0f, 0.0f, 0.0f, 2.0f, 3.0f, 0.0f, 0.0f, 0.0f, 1.0f}};
+		}
+
+		std::chrono::duration<double> actualDuration;
+		benchmark(iterations, actualDuration, [&matrices, &inverses]()
+		{
+			for (std::size_t index = 0u; index < count; ++index)
+			{
+				inverses[index] = matrices[index].inverted();
+			}
+		});
+
+		std::cout << count * iterations << " 4x4 inversions "
+				  << std::chrono::duration_cast<std::chrono::nanoseconds>(actualDuration).count() / double(count * iterations) << " ns\n";
+	}
+
+	// Vectorized 4x4 kernels
+	testProducts4<float>();
+	testProducts4<double>();
+
+	{
+		// Element-wise expressions are fused and stay usable in constant expressions
+		constexpr float element = []()
+		{
+			const Vector3_f	vector{{1.0f, 2.0f, 3.0f}};
+			const Vector3_f	result = vector + vector * 2.0f - vector / 2.0f;
+			return result[2u];
+		}();
+
+		static_assert(element == 7.5f);
+
+		const Vector4_i32	left{{1, 2, 3, 4}};
+		const Vector4_i32	right{{5, 6, 7, 8}};
+		Vector4_i32			result = left + right * 2 - (-left);
+
+		assertEqual(result, Vector4_i32{{12, 16, 20, 24}});
+
+		result += left - right;
+		result -= 2 * left;
+
+		assertEqual(result, Vector4_i32{{6, 8, 10, 12}});
+
+		assertEqual(Vector3_d{{3.0, 0.0, 4.0}}.normalized(), Vector3_d{{0.6, 0.0, 0.8}});
+		assertEqual(Vector3_d{{0.0, 2.0, 0.0}}.norm(), 2.0);
+	}
+
 	{
 		const Matrix3x3_f matrix{traits::initialization::identity};
 
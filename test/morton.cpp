@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <morton.hpp>
+
+#include "test.hpp"
+
+using namespace nd::math;
+
+template <typename Code, std::size_t Order>
+Code referenceSpread(const Code value)
+{
+	Code returnValue = 0u;
+
+	for (std::size_t bit = 0u; bit < detail::mortonBits<Code, Order>; ++bit)
+	{
+		returnValue |= ((value >> bit) & Code{1u}) << (bit * Order);
+	}
+
+	return returnValue;
+}
+
+template <typename Code, std::size_t Order>
+void testSpread()
+{
+	std::mt19937_64 generator{1u};
+
+	for (std::size_t iteration = 0u; iteration < 1000u; ++iteration)
+	{
+		const Code value = Code(generator()) & Code((Code{1u} << detail::mortonBits<Code, Order>) - 1u);
+
+		Code spread = value;
+		detail::mortonSpread<Code, Order>(spread);
+
+		assertEqual(spread, referenceSpread<Code, Order>(value));
+	}
+}
+
+template <typename Code, typename Layout>
+void testCodes()
+{
+	constexpr Code largest = (Code{1u} << detail::mortonBits<Code, 3u>) - 1u;
+
+	VectorSoA<float, 3u, Layout> points;
+
+	// More points than a register holds, so both the vectorized body and the scalar tail compute codes
+	for (std::size_t index = 0u; index < 37u; ++index)
+	{
+		points.emplace_back(0.0f, 0.0f, 0.0f);
+		points.emplace_back(1.0f, 0.0f, 0.0f);
+		points.emplace_back(0.0f, 1.0f, 1.0f);
+		points.emplace_back(0.5f, 2.0f, -1.0f);
+	}
+
+	std::vector<Code> codes(points.size());
+
+	mortonCodes(points.view(), BoundingBox3_f{{{0.0f, 0.0f, 0.0f}}, {{1.0f, 1.0f, 1.0f}}}, std::span<Code>{codes});
+
+	const Code half = Code(0.5f * float(largest));
+
+	for (std::size_t index = 0u; index < points.size(); index += 4u)
+	{
+		assertEqual(codes[index], Code{0u});
+		assertEqual(codes[index + 1u], referenceSpread<Code, 3u>(largest));
+		assertEqual(codes[index + 2u], Code((referenceSpread<Code, 3u>(largest) << 1u) | (referenceSpread<Code, 3u>(largest) << 2u)));
+		assertEqual(codes[index + 3u], Code(referenceSpread<Code, 3u>(half) | (referenceSpread<Code, 3u>(largest) << 1u)));
+	}
+}
+
+int main(int, char **)
+{
+	testSpread<std::uint32_t, 3u>();
+	testSpread<std::uint64_t, 3u>();
+	testSpread<std::uint32_t, 2u>();
+	testSpread<std::uint64_t, 2u>();
+	testSpread<std::uint32_t, 4u>();
+
+	testCodes<std::uint32_t, layout::SoA>();
+	testCodes<std::uint64_t, layout::SoA>();
+	testCodes<std::uint32_t, layout::AoSoA<8u>>();
+
+	{
+		// Few keys per chunk make the scatter cross many chunks
+		std::mt19937_64 generator{2u};
+
+		std::vector<std::uint64_t> keys(10007u);
+		std::vector<std::uint32_t> values(keys.size());
+
+		for (std::uint64_t &key : keys)
+		{
+			key = generator() >> (generator() % 64u);
+		}
+
+		// Equal keys keep their order
+		keys[17u] = keys[5000u] = keys[9000u];
+		std::iota(values.begin(), values.end(), std::uint32_t{0u});
+
+		std::vector<std::uint32_t> expected = values;
+		std::stable_sort(expected.begin(), expected.end(), [&keys](const std::uint32_t left, const std::uint32_t right)
+		{
+			return keys[left] < keys[right];
+		});
+
+		radixSort(std::span<std::uint64_t>{keys}, std::span<std::uint32_t>{values}, 100u);
+
+		assertEqual(values, expected);
+		assertEqual(std::is_sorted(keys.begin(), keys.end()), true);
+
+		// Keys sharing their high bytes skip those passes
+		std::vector<std::uint32_t> small = {3u, 1u, 2u, 1u, 0u};
+		std::vector<std::uint32_t> order = {0u, 1u, 2u, 3u, 4u};
+
+		radixSort(std::span<std::uint32_t>{small}, std::span<std::uint32_t>{order});
+
+		assertEqual(small, std::vector<std::uint32_t>{0u, 1u, 1u, 2u, 3u});
+		assertEqual(order, std::vector<std::uint32_t>{4u, 1u, 3u, 2u, 0u});
+	}
+
+	{
+		std::mt19937							generator{3u};
+		std::uniform_real_distribution<double>	distribution{-5.0, 5.0};
+
+		VectorSoA3_d		points;
+		std::vector<int>	labels;
+
+		for (std::size_t index = 0u; index < 3001u; ++index)
+		{
+			points.emplace_back(distribution(generator), distribution(generator), distribution(generator));
+			labels.push_back(int(index));
+		}
+
+		const VectorSoA3_d original = points.clone();
+		VectorSoA3_d attached = points.clone();
+
+		const std::vector<std::uint32_t> permutation = mortonSort<std::uint64_t>(points, labels, attached);
+
+		// Attributes follow their points and the permutation reorders further data the same way
+		VectorSoA3_d later = original.clone();
+		permute(later, permutation);
+
+		for (std::size_t index = 0u; index < points.size(); ++index)
+		{
+			assertEqual(ColumnVector3_d(points[index]), ColumnVector3_d(original[std::size_t(labels[index])]));
+			assertEqual(ColumnVector3_d(attached[index]), ColumnVector3_d(points[index]));
+			assertEqual(ColumnVector3_d(later[index]), ColumnVector3_d(points[index]));
+			assertEqual(std::size_t(permutation[index]), std::size_t(labels[index]));
+		}
+
+		std::vector<std::uint64_t> codes(points.size());
+		mortonCodes(points, std::span<std::uint64_t>{codes});
+
+		assertEqual(std::is_sorted(codes.begin(), codes.end()), true);
+	}
+
+	{
+		constexpr std::size_t	count		= 10000000u;
+		constexpr std::size_t	iterations	= 3u;
+
+		std::mt19937							generator{4u};
+		std::uniform_real_distribution<float>	distribution{0.0f, 1.0f};
+
+		VectorSoA3_f points;
+
+		for (std::size_t index = 0u; index < count; ++index)
+		{
+			points.emplace_back(distribution(generator), distribution(generator), distribution(generator));
+		}
+
+		std::vector<std::uint32_t> codes(count);
+		std::vector<std::uint32_t> values(count);
+
+		std::chrono::duration<double> actualDuration;
+		benchmark(iterations, actualDuration, [&points, &codes]()
+		{
+			mortonCodes(points, std::span<std::uint32_t>{codes});
+		});
+
+		std::cout << count << " 30 bit Morton codes computed in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		std::vector<std::uint32_t> keys;
+
+		benchmark(iterations, actualDuration, [&codes, &keys, &values]()
+		{
+			keys = codes;
+			std::iota(values.begin(), values.end(), std::uint32_t{0u});
+			radixSort(std::span<std::uint32_t>{keys}, std::span<std::uint32_t>{values});
+		});
+
+		std::cout << count << " keys radix sorted in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		benchmark(iterations, actualDuration, [&codes, &values]()
+		{
+			std::iota(values.begin(), values.end(), std::uint32_t{0u});
+			std::sort(values.begin(), values.end(), [&codes](const std::uint32_t left, const std::uint32_t right)
+			{
+				return codes[left] < codes[right];
+			});
+		});
+
+		std::cout << count << " keys sorted by std::sort in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		// Summing the distances between consecutive points walks memory in order, so only the spatial locality of the order matters
+		const auto walk = [&points]()
+		{
+			float length = 0.0f;
+
+			for (std::size_t index = 1u; index < points.size(); ++index)
+			{
+				length += (ColumnVector3_f(points[index]) - ColumnVector3_f(points[index - 1u])).norm();
+			}
+
+			return length;
+		};
+
+		const float randomLength = walk();
+
+		benchmark(1u, actualDuration, [&points]()
+		{
+			mortonSort(points);
+		});
+
+		std::cout << count << " points sorted into Z-order in " << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count()
+				  << " us, path length " << randomLength << " before and " << walk() << " after\n";
+	}
+
+	return EXIT_SUCCESS;
+}
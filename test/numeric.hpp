@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <random>
+#include <type_traits>
+
+#include <dualquaternion.hpp>
+#include <matrix.hpp>
+#include <quaternion.hpp>
+
+///
+/// Returns the largest absolute difference between the elements of \a left and \a right.
+///
+template <typename ValueType, typename = std::enable_if_t<std::is_floating_point_v<ValueType>>>
+inline ValueType maximumDifference(const ValueType left, const ValueType right)
+{
+	return std::abs(left - right);
+}
+
+template <typename ValueType, std::size_t Rows, std::size_t Columns>
+inline ValueType maximumDifference(const nd::math::Matrix<ValueType, Rows, Columns> &left, const nd::math::Matrix<ValueType, Rows, Columns> &right)
+{
+	ValueType returnValue = {};
+
+	for (std::size_t index = 0u; index < Rows * Columns; ++index)
+	{
+		returnValue = std::max(returnValue, std::abs(left.data()[index] - right.data()[index]));
+	}
+
+	return returnValue;
+}
+
+template <typename ValueType>
+inline ValueType maximumDifference(const nd::math::Quaternion<ValueType> &left, const nd::math::Quaternion<ValueType> &right)
+{
+	ValueType returnValue = {};
+
+	for (std::size_t index = 0u; index < 4u; ++index)
+	{
+		returnValue = std::max(returnValue, std::abs(left[index] - right[index]));
+	}
+
+	return returnValue;
+}
+
+template <typename ValueType>
+inline ValueType maximumDifference(const nd::math::DualQuaternion<ValueType> &left, const nd::math::DualQuaternion<ValueType> &right)
+{
+	return std::max(maximumDifference(left.real(), right.real()), maximumDifference(left.dual(), right.dual()));
+}
+
+///
+/// Fails unless no element of \a actual differs from the one of \a expected by more than \a tolerance.
+///
+template <typename T, typename Tolerance>
+inline void assertNear(const T &actual, const T &expected, const Tolerance tolerance)
+{
+	if (!(maximumDifference(actual, expected) <= tolerance))
+	{
+		std::exit(EXIT_FAILURE);
+	}
+}
+
+///
+/// Returns a uniformly distributed unit quaternion, normalizing four normally distributed components.
+///
+template <typename ValueType>
+inline nd::math::Quaternion<ValueType> randomRotation(std::mt19937 &generator)
+{
+	std::normal_distribution<ValueType> distribution;
+
+	return nd::math::Quaternion<ValueType>{distribution(generator), distribution(generator), distribution(generator),
+										   distribution(generator)}.normalized();
+}
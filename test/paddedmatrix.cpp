@@ -0,0 +1,151 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <memory>
+
+#include <matrix.hpp>
+#include <paddedmatrix.hpp>
+
+#include "test.hpp"
+
+using namespace nd::math;
+
+template <typename ValueType>
+void testVectors3()
+{
+	const Vector3<ValueType>		left{{1, -2, 3}};
+	const Vector3<ValueType>		right{{4, 5, -6}};
+	const PaddedVector3<ValueType>	paddedLeft{left};
+	const PaddedVector3<ValueType>	paddedRight{right};
+
+	static_assert(PaddedVector3<ValueType>::stride() == 4u);
+	static_assert(alignof (PaddedVector3<ValueType>) == std::min(4u * sizeof (ValueType), simd::registerSize));
+
+	assertEqual(Vector3<ValueType>{paddedLeft.cross(paddedRight)}, left.cross(right));
+	assertEqual(paddedLeft.squareNorm(), left.squareNorm());
+	assertEqual(paddedLeft.dot(paddedRight), ValueType(4 - 10 - 18));
+
+	// The padding lane stays zero and never leaks into the logical elements
+	const PaddedVector3<ValueType> crossed = paddedLeft.cross(paddedRight);
+	assertEqual(crossed.data()[3u], ValueType(0));
+
+	PaddedVector3<ValueType> scaled = paddedLeft;
+	scaled /= ValueType(0);
+	assertEqual(scaled.data()[3u], ValueType(0));
+
+	scaled = paddedLeft;
+	scaled *= std::numeric_limits<ValueType>::infinity();
+	assertEqual(scaled.data()[3u], ValueType(0));
+
+	const PaddedVector3<ValueType> normalized = PaddedVector3<ValueType>{{3, 0, 4}}.normalized();
+	assertEqual(normalized, PaddedVector3<ValueType>{{ValueType(0.6), 0, ValueType(0.8)}});
+}
+
+int main(int, char **)
+{
+	{
+		// Aligned storage leaves the size of tightly packed matrices unchanged
+		static_assert((alignof (Matrix4x4_f) == std::min<std::size_t>(64u, simd::registerSize)) & (sizeof (Matrix4x4_f) == 64u));
+		static_assert((alignof (Vector4_d) == std::min<std::size_t>(32u, simd::registerSize)) & (sizeof (Vector4_d) == 32u));
+		static_assert((alignof (Vector3_f) == alignof (float)) & (sizeof (Vector3_f) == 12u));
+
+		static_assert((PaddedMatrix3x3_f::stride() == 4u) & (sizeof (PaddedMatrix3x3_f) == 48u) & (alignof (PaddedMatrix3x3_f) == 16u));
+		static_assert(PaddedMatrix<float, 2u, 5u>::stride() == 8u);
+		static_assert(PaddedMatrix<float, 3u, 1u>::stride() == 1u);
+	}
+
+	testVectors3<float>();
+	testVectors3<double>();
+
+	{
+		// Products of padded matrices match the tightly packed ones
+		const Matrix3x3_f	left{{1.0f, 2.0f, 3.0f, -4.0f, 5.0f, 6.0f, 7.0f, 8.0f, -9.0f}};
+		const Matrix3x3_f	right{{2.0f, 0.0f, 1.0f, 1.0f, -1.0f, 4.0f, 0.0f, 5.0f, 2.0f}};
+		const Vector3_f		vector{{1.0f, -2.0f, 3.0f}};
+
+		const PaddedMatrix3x3_f	paddedLeft{left};
+		const PaddedMatrix3x3_f	paddedRight{right};
+		const PaddedVector3_f	paddedVector{vector};
+
+		assertEqual(Matrix3x3_f{paddedLeft * paddedRight}, left * right);
+		assertEqual(Vector3_f{paddedVector * paddedRight}, vector * right);
+		assertEqual(Matrix3x3_f{paddedLeft.transposed()}, left.transposed());
+		assertEqual(paddedLeft * PaddedMatrix3x3_f{traits::initialization::identity}, paddedLeft);
+
+		PaddedMatrix3x3_f sum{paddedLeft + paddedRight * 2.0f};
+		sum -= paddedRight;
+		sum += paddedLeft;
+
+		assertEqual(Matrix3x3_f{sum}, Matrix3x3_f{left * 2.0f + right});
+		assertEqual(sum.data()[3u] + sum.data()[7u] + sum.data()[11u], 0.0f);
+
+		const MatrixView<const float> rows = view(paddedLeft);
+		assertEqual(rows[2u][1u], 8.0f);
+		assertEqual(paddedLeft[2u][1u], 8.0f);
+
+		// Constant evaluation uses the scalar paths
+		constexpr float element = (PaddedMatrix3x3_f{{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f}} *
+								   PaddedMatrix3x3_f{traits::initialization::identity})[2u][1u];
+		static_assert(element == 8.0f);
+	}
+
+	{
+		// Large padded products use the blocked kernel with their padded strides
+		constexpr std::size_t l = 45u;
+		constexpr std::size_t m = 67u;
+		constexpr std::size_t n = 37u;
+
+		const std::unique_ptr<Matrix<float, l, m>>	left		= std::make_unique<Matrix<float, l, m>>();
+		const std::unique_ptr<Matrix<float, m, n>>	right		= std::make_unique<Matrix<float, m, n>>();
+		std::unique_ptr<Matrix<float, l, n>>		expected	= std::make_unique<Matrix<float, l, n>>();
+
+		for (std::size_t index = 0u; index < l * m; ++index)
+		{
+			left->data()[index] = float(index % 7u) - 3.0f;
+		}
+
+		for (std::size_t index = 0u; index < m * n; ++index)
+		{
+			right->data()[index] = float(index % 5u) - 2.0f;
+		}
+
+		mul(*expected, *left, *right);
+
+		const std::unique_ptr<PaddedMatrix<float, l, m>>	paddedLeft		= std::make_unique<PaddedMatrix<float, l, m>>(*left);
+		const std::unique_ptr<PaddedMatrix<float, m, n>>	paddedRight		= std::make_unique<PaddedMatrix<float, m, n>>(*right);
+		std::unique_ptr<PaddedMatrix<float, l, n>>			paddedResult	= std::make_unique<PaddedMatrix<float, l, n>>();
+
+		mul(*paddedResult, *paddedLeft, *paddedRight);
+
+		assertEqual(Matrix<float, l, n>{*paddedResult}, *expected);
+	}
+
+	{
+		constexpr std::size_t	count		= 4096u;
+		constexpr std::size_t	iterations	= 1000u;
+		const PaddedVector3_f	axis{{0.0f, 0.6f, 0.8f}};
+
+		const std::unique_ptr<PaddedVector3_f[]> vectors = std::make_unique<PaddedVector3_f[]>(count);
+
+		for (std::size_t index = 0u; index < count; ++index)
+		{
+			vectors[index] = PaddedVector3_f{{float(index), 1.0f, -float(index)}};
+		}
+
+		std::chrono::duration<double> actualDuration;
+		benchmark(iterations, actualDuration, [&vectors, &axis]()
+		{
+			for (std::size_t index = 0u; index < count; ++index)
+			{
+				vectors[index] = vectors[index].cross(axis);
+			}
+		});
+
+		std::cout << count * iterations << " padded cross products "
+				  << std::chrono::duration_cast<std::chrono::nanoseconds>(actualDuration).count() / double(count * iterations) << " ns\n";
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -1,19 +1,220 @@
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstddef>
 #include <cstdlib>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <random>
+#include <span>
+#include <vector>
 
 #include <matrix.hpp>
 #include <quaternion.hpp>
+#include <quaternionsoa.hpp>
 #include <units.hpp>
+#include <vectorsoa.hpp>
 
+#include "numeric.hpp"
 #include "test.hpp"
 
 using namespace nd::math;
 
+///
+/// Reference Hamilton product written out component by component, like the scalar path of \ref Quaternion::operator*.
+///
+template <typename ValueType>
+Quaternion<ValueType> referenceProduct(const Quaternion<ValueType> &left, const Quaternion<ValueType> &right)
+{
+	return Quaternion<ValueType>{left[0u] * right[0u] - left[1u] * right[1u] - left[2u] * right[2u] - left[3u] * right[3u],
+								 left[0u] * right[1u] + left[1u] * right[0u] + left[2u] * right[3u] - left[3u] * right[2u],
+								 left[0u] * right[2u] - left[1u] * right[3u] + left[2u] * right[0u] + left[3u] * right[1u],
+								 left[0u] * right[3u] + left[1u] * right[2u] - left[2u] * right[1u] + left[3u] * right[0u]};
+}
+
+///
+/// Checks the vectorized product and conjugation against constant evaluation, which takes the scalar path, and against the reference.
+///
+template <typename ValueType>
+void testProduct()
+{
+	constexpr ValueType tolerance = std::numeric_limits<ValueType>::epsilon() * ValueType(16);
+
+	{
+		constexpr Quaternion<ValueType> q0{1, 2, 3, 4};
+		constexpr Quaternion<ValueType> q1{5, 6, 7, 8};
+
+		constexpr Quaternion<ValueType> product		= q0 * q1;
+		constexpr Quaternion<ValueType> conjugated	= q0.conjugated();
+
+		// Integral components keep every product exact, so both paths agree bit for bit
+		assertEqual(Vector4<ValueType>(product), Vector4<ValueType>{{-60, 12, 30, 24}});
+		assertEqual(Vector4<ValueType>(q0 * q1), Vector4<ValueType>(product));
+		assertEqual(Vector4<ValueType>(q1 * q0), Vector4<ValueType>{{-60, 20, 14, 32}});
+
+		assertEqual(Vector4<ValueType>(conjugated), Vector4<ValueType>{{1, -2, -3, -4}});
+		assertEqual(Vector4<ValueType>(q0.conjugated()), Vector4<ValueType>(conjugated));
+		assertEqual(Vector4<ValueType>(q0.conjugated().conjugated()), Vector4<ValueType>(q0));
+	}
+
+	std::mt19937 generator{8u};
+
+	for (std::size_t iteration = 0u; iteration < 1000u; ++iteration)
+	{
+		const Quaternion<ValueType> left	= randomRotation<ValueType>(generator);
+		const Quaternion<ValueType> right	= randomRotation<ValueType>(generator);
+
+		assertNear(left * right, referenceProduct(left, right), tolerance);
+		assertNear(left * left.conjugated(), Quaternion<ValueType>{1, 0, 0, 0}, tolerance);
+
+		Quaternion<ValueType> composed = left;
+		composed *= right;
+
+		assertEqual(Vector4<ValueType>(composed), Vector4<ValueType>(left * right));
+	}
+}
+
+///
+/// Checks the cross product rotation against the sandwich product $q v q^{-1}$, and the batch rotations against the single ones on a view
+/// starting in the middle of a register, so the head, body and tail of the batch are covered.
+///
+template <typename ValueType, typename Layout>
+void testRotate()
+{
+	constexpr ValueType tolerance = std::numeric_limits<ValueType>::epsilon() * ValueType(16);
+
+	std::mt19937							generator{5u};
+	std::uniform_real_distribution<ValueType>	distribution{ValueType(-1), ValueType(1)};
+
+	{
+		// A third of a turn about the diagonal cycles the axes, exactly
+		const Quaternion<ValueType> q{ValueType(0.5), ValueType(0.5), ValueType(0.5), ValueType(0.5)};
+
+		assertEqual(q.rotate(Vector3<ValueType>{{1, 0, 0}}), Vector3<ValueType>{{0, 1, 0}});
+		assertEqual(q.rotate(Vector3<ValueType>{{0, 1, 0}}), Vector3<ValueType>{{0, 0, 1}});
+		assertEqual(q.rotate(ColumnVector3<ValueType>{{0, 0, 1}}), ColumnVector3<ValueType>{{1, 0, 0}});
+	}
+
+	VectorSoA<ValueType, 4u, Layout> rotations;
+	VectorSoA<ValueType, 3u, Layout> vectors;
+
+	for (std::size_t index = 0u; index < 103u; ++index)
+	{
+		const Quaternion<ValueType> q = randomRotation<ValueType>(generator);
+		const Vector3<ValueType>	v{{distribution(generator), distribution(generator), distribution(generator)}};
+
+		const Vector3<ValueType> expected = q * Quaternion<ValueType>{v} * q.inverted();
+
+		assertNear(q.rotate(v), expected, tolerance);
+
+		rotations.push_back(ColumnVector<ValueType, 4u>(Vector4<ValueType>(q).transposed()));
+		vectors.push_back(v.transposed());
+	}
+
+	constexpr std::size_t offset = 3u;
+	constexpr std::size_t count = 97u;
+
+	const Quaternion<ValueType> q = randomRotation<ValueType>(generator);
+
+	VectorSoA<ValueType, 3u, Layout> result = vectors.clone();
+	rotate(q, vectors.view(offset, count), result.view(offset, count));
+
+	VectorSoA<ValueType, 3u, Layout> inPlace = vectors.clone();
+	rotate(q, inPlace);
+
+	for (std::size_t index = 0u; index < vectors.size(); ++index)
+	{
+		const ColumnVector3<ValueType> vector = vectors[index];
+		const ColumnVector3<ValueType> expected = ((index >= offset) & (index < (offset + count))) ? q.rotate(vector) : vector;
+
+		assertNear(ColumnVector3<ValueType>(result[index]), expected, tolerance);
+		assertNear(ColumnVector3<ValueType>(inPlace[index]), q.rotate(vector), tolerance);
+	}
+
+	result = vectors.clone();
+	rotate(rotations.view(offset, count), vectors.view(offset, count), result.view(offset, count));
+
+	for (std::size_t index = offset; index < (offset + count); ++index)
+	{
+		const ColumnVector<ValueType, 4u>	components	= rotations[index];
+		const Quaternion<ValueType>			rotation{components[0u], components[1u], components[2u], components[3u]};
+
+		assertNear(ColumnVector3<ValueType>(result[index]), rotation.rotate(ColumnVector3<ValueType>(vectors[index])), tolerance);
+	}
+}
+
+///
+/// Checks the rotation matrices against \ref Quaternion::rotate and the batch conversion against the single one.
+///
+template <typename ValueType, typename Layout>
+void testRotationMatrix()
+{
+	constexpr ValueType tolerance = std::numeric_limits<ValueType>::epsilon() * ValueType(16);
+
+	{
+		// A third of a turn about the diagonal permutes the axes, which constant evaluation already gets exactly
+		constexpr Matrix3x3<ValueType> rotation = Quaternion<ValueType>{ValueType(0.5), ValueType(0.5), ValueType(0.5), ValueType(0.5)}.toRotationMatrix3();
+
+		assertEqual(rotation, Matrix3x3<ValueType>{{0, 0, 1, 1, 0, 0, 0, 1, 0}});
+
+		const Matrix4x4<ValueType> homogeneous = Quaternion<ValueType>{ValueType(0.5), ValueType(0.5), ValueType(0.5), ValueType(0.5)}.toRotationMatrix();
+
+		assertEqual(homogeneous, Matrix4x4<ValueType>{{0, 0, 1, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1}});
+	}
+
+	std::mt19937								generator{10u};
+	std::uniform_real_distribution<ValueType>	distribution{ValueType(-1), ValueType(1)};
+
+	VectorSoA<ValueType, 4u, Layout> rotations;
+
+	for (std::size_t index = 0u; index < 101u; ++index)
+	{
+		const Quaternion<ValueType>		q = randomRotation<ValueType>(generator);
+		const ColumnVector3<ValueType>	v{{distribution(generator), distribution(generator), distribution(generator)}};
+
+		assertNear(ColumnVector3<ValueType>(q.toRotationMatrix3() * v), q.rotate(v), tolerance);
+		const ColumnVector3<ValueType> rotated = q.rotate(v);
+
+		assertNear(ColumnVector4<ValueType>(q.toRotationMatrix() * ColumnVector4<ValueType>{{v[0u], v[1u], v[2u], 1}}),
+				   ColumnVector4<ValueType>{{rotated[0u], rotated[1u], rotated[2u], 1}}, tolerance);
+
+		rotations.push_back(ColumnVector4<ValueType>(Vector4<ValueType>(q).transposed()));
+	}
+
+	constexpr std::size_t offset	= 3u;
+	constexpr std::size_t count		= 97u;
+
+	std::vector<Matrix3x3<ValueType>> matrices3(count);
+	std::vector<Matrix4x4<ValueType>> matrices4(count);
+
+	toRotationMatrices(rotations.view(offset, count), std::span<Matrix3x3<ValueType>>{matrices3});
+	toRotationMatrices(rotations.view(offset, count), std::span<Matrix4x4<ValueType>>{matrices4});
+
+	for (std::size_t index = 0u; index < count; ++index)
+	{
+		const ColumnVector4<ValueType>	components	= rotations[offset + index];
+		const Quaternion<ValueType>		rotation{components[0u], components[1u], components[2u], components[3u]};
+
+		assertNear(matrices3[index], rotation.toRotationMatrix3(), tolerance);
+		assertNear(matrices4[index], rotation.toRotationMatrix(), tolerance);
+		assertEqual(matrices4[index][3u][3u], ValueType(1));
+	}
+}
+
 int main(int, char **)
 {
+	testRotate<float, layout::SoA>();
+	testRotate<double, layout::SoA>();
+	testRotate<float, layout::AoSoA<8u>>();
+	testRotate<double, layout::AoSoA<4u>>();
+
+	testProduct<float>();
+	testProduct<double>();
+
+	testRotationMatrix<float, layout::SoA>();
+	testRotationMatrix<double, layout::AoSoA<4u>>();
+
 //	{
 //		Quaternion_f q{1.0f, 1.0f, 1.0f, 1.0f};
 
@@ -50,5 +251,141 @@ int main(int, char **)
 		std::cout << q << " " << q.inverted() << " " << r << "\n";
 	}
 
+	{
+		// Instances of a frame, which fit into the caches so the conversion is not bound by memory bandwidth
+		constexpr std::size_t count			= 16384u;
+		constexpr std::size_t iterations	= 1000u;
+
+		std::mt19937 generator{11u};
+
+		VectorSoA<float, 4u>		rotations;
+		std::vector<Matrix4x4_f>	matrices(count);
+
+		for (std::size_t index = 0u; index < count; ++index)
+		{
+			rotations.push_back(ColumnVector4_f(Vector4_f(randomRotation<float>(generator)).transposed()));
+		}
+
+		std::chrono::duration<double> actualDuration;
+		benchmark(iterations, actualDuration, [&rotations, &matrices]()
+		{
+			for (std::size_t index = 0u; index < count; ++index)
+			{
+				const ColumnVector4_f components = rotations[index];
+				matrices[index] = Quaternion_f{components[0u], components[1u], components[2u], components[3u]}.toRotationMatrix();
+			}
+		});
+
+		std::cout << count << " rotation matrices converted one by one in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		benchmark(iterations, actualDuration, [&rotations, &matrices]()
+		{
+			toRotationMatrices(rotations, std::span<Matrix4x4_f>{matrices});
+		});
+
+		std::cout << count << " rotation matrices batch converted in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+	}
+
+	{
+		constexpr std::size_t count			= 10000000u;
+		constexpr std::size_t iterations	= 3u;
+
+		std::mt19937 generator{9u};
+
+		std::vector<Quaternion_f> rotations;
+
+		for (std::size_t index = 0u; index < count; ++index)
+		{
+			rotations.push_back(randomRotation<float>(generator));
+		}
+
+		Quaternion_f orientation{1.0f, 0.0f, 0.0f, 0.0f};
+
+		// Every product depends on the previous one like integrating an attitude does, so latency rather than throughput counts
+		std::chrono::duration<double> actualDuration;
+		benchmark(iterations, actualDuration, [&rotations, &orientation]()
+		{
+			for (const Quaternion_f &rotation : rotations)
+			{
+				orientation = referenceProduct(orientation, rotation.conjugated());
+			}
+		});
+
+		std::cout << count << " orientations composed component by component in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		benchmark(iterations, actualDuration, [&rotations, &orientation]()
+		{
+			for (const Quaternion_f &rotation : rotations)
+			{
+				orientation *= rotation.conjugated();
+			}
+		});
+
+		std::cout << count << " orientations composed in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us " << orientation << "\n";
+	}
+
+	{
+		constexpr std::size_t count			= 10000000u;
+		constexpr std::size_t iterations	= 3u;
+
+		std::mt19937							generator{6u};
+		std::uniform_real_distribution<float>	distribution{-1.0f, 1.0f};
+
+		VectorSoA3_f			vectors;
+		VectorSoA<float, 4u>	rotations;
+
+		for (std::size_t index = 0u; index < count; ++index)
+		{
+			vectors.emplace_back(distribution(generator), distribution(generator), distribution(generator));
+			rotations.push_back(ColumnVector4_f(Vector4_f(randomRotation<float>(generator)).transposed()));
+		}
+
+		const Quaternion_f	q = randomRotation<float>(generator);
+		VectorSoA3_f		result(count);
+
+		std::chrono::duration<double> actualDuration;
+		benchmark(iterations, actualDuration, [&q, &vectors, &result]()
+		{
+			for (std::size_t index = 0u; index < count; ++index)
+			{
+				result[index] = Vector3_f(q * Quaternion_f{Vector3_f(ColumnVector3_f(vectors[index]).transposed())} * q.inverted()).transposed();
+			}
+		});
+
+		std::cout << count << " vectors rotated by sandwich products in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		benchmark(iterations, actualDuration, [&q, &vectors, &result]()
+		{
+			for (std::size_t index = 0u; index < count; ++index)
+			{
+				result[index] = q.rotate(ColumnVector3_f(vectors[index]));
+			}
+		});
+
+		std::cout << count << " vectors rotated one by one in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		benchmark(iterations, actualDuration, [&q, &vectors, &result]()
+		{
+			rotate(q, vectors, result);
+		});
+
+		std::cout << count << " vectors batch rotated in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		benchmark(iterations, actualDuration, [&rotations, &vectors, &result]()
+		{
+			rotate(rotations, vectors, result);
+		});
+
+		std::cout << count << " vectors batch rotated by their own quaternions in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+	}
+
 	return EXIT_SUCCESS;
 }
@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <quaternion.hpp>
+#include <quaternionsoa.hpp>
+#include <units.hpp>
+
+#include "numeric.hpp"
+#include "test.hpp"
+
+using namespace nd::math;
+
+///
+/// Checks the single quaternion interpolations on rotations about a common axis, whose spherical interpolation is known in closed form.
+///
+template <typename ValueType>
+void testInterpolation()
+{
+	constexpr ValueType tolerance = std::numeric_limits<ValueType>::epsilon() * ValueType(64);
+
+	const Vector3<ValueType> axis{{ValueType(1), ValueType(2), ValueType(-2)}};
+
+	const Quaternion<ValueType> from{units::Radians<ValueType>{ValueType(0.25)}, axis};
+	const Quaternion<ValueType> to{units::Radians<ValueType>{ValueType(2.5)}, axis};
+
+	for (const ValueType weight : {ValueType(0), ValueType(0.25), ValueType(0.5), ValueType(1)})
+	{
+		const Quaternion<ValueType> expected{units::Radians<ValueType>{ValueType(0.25) + weight * ValueType(2.25)}, axis};
+
+		assertNear(slerp(from, to, weight), expected, tolerance);
+
+		// The negated quaternion is the same rotation, so both take the shorter arc
+		assertNear(slerp(from, to * ValueType(-1), weight), expected, tolerance);
+
+		// The polynomial approximates the ratios of sines, renormalization keeps the result a rotation
+		assertNear(fastSlerp(from, to, weight), expected, ValueType(1.0E-4));
+		assertNear(fastSlerp(from, to, weight).norm(), ValueType(1), tolerance);
+	}
+
+	// Linear interpolation hits the endpoints and the middle of the arc, but not the points in between
+	assertNear(nlerp(from, to, ValueType(0)), from, tolerance);
+	assertNear(nlerp(from, to, ValueType(1)), to, tolerance);
+	assertNear(nlerp(from, to * ValueType(-1), ValueType(0.5)), slerp(from, to, ValueType(0.5)), tolerance);
+	assertEqual(maximumDifference(nlerp(from, to, ValueType(0.25)), slerp(from, to, ValueType(0.25))) > ValueType(1.0E-3), true);
+
+	// Nearly identical rotations blend without dividing by a vanishing sine
+	const Quaternion<ValueType> close{units::Radians<ValueType>{ValueType(0.2501)}, axis};
+
+	assertNear(slerp(from, close, ValueType(0.5)), nlerp(from, close, ValueType(0.5)), tolerance);
+}
+
+template <typename ValueType, typename Layout>
+void testContainer()
+{
+	std::mt19937 generator{12u};
+
+	std::vector<Quaternion<ValueType>> quaternions;
+
+	for (std::size_t index = 0u; index < 37u; ++index)
+	{
+		quaternions.push_back(randomRotation<ValueType>(generator));
+	}
+
+	const QuaternionSoA<ValueType, Layout> assigned{std::span<const Quaternion<ValueType>>{quaternions}};
+
+	QuaternionSoA<ValueType, Layout> pushed;
+
+	for (const Quaternion<ValueType> &quaternion : quaternions)
+	{
+		pushed.push_back(quaternion);
+	}
+
+	assertEqual(assigned.size(), quaternions.size());
+	assertEqual(pushed.size(), quaternions.size());
+
+	for (std::size_t index = 0u; index < quaternions.size(); ++index)
+	{
+		assertEqual(Vector4<ValueType>(assigned[index]), Vector4<ValueType>(quaternions[index]));
+		assertEqual(Vector4<ValueType>(pushed[index]), Vector4<ValueType>(quaternions[index]));
+	}
+
+	QuaternionSoA<ValueType, Layout> copy = assigned.clone();
+	copy.set(5u, Quaternion<ValueType>{1, 0, 0, 0});
+	copy.resize(40u);
+
+	assertEqual(Vector4<ValueType>(copy[5u]), Vector4<ValueType>{{1, 0, 0, 0}});
+	assertEqual(Vector4<ValueType>(copy[39u]), Vector4<ValueType>{traits::initialization::zero});
+	assertEqual(Vector4<ValueType>(assigned[5u]), Vector4<ValueType>(quaternions[5u]));
+
+	// The components are vectors for the vector kernels
+	assertEqual(ColumnVector4<ValueType>(copy.view()[6u]), ColumnVector4<ValueType>(Vector4<ValueType>(quaternions[6u]).transposed()));
+}
+
+///
+/// Checks the batch blends against the single ones on views starting in the middle of a register, in chunks small enough to be distributed
+/// across threads.
+///
+template <typename ValueType, typename Layout>
+void testBlend()
+{
+	constexpr ValueType tolerance = std::numeric_limits<ValueType>::epsilon() * ValueType(64);
+
+	constexpr std::size_t size		= 1003u;
+	constexpr std::size_t offset	= 3u;
+	constexpr std::size_t count		= 997u;
+
+	std::mt19937							generator{13u};
+	std::uniform_real_distribution<ValueType>	distribution{ValueType(0), ValueType(1)};
+
+	QuaternionSoA<ValueType, Layout>	from;
+	QuaternionSoA<ValueType, Layout>	to;
+	std::vector<ValueType>				weights(count);
+
+	for (std::size_t index = 0u; index < size; ++index)
+	{
+		from.push_back(randomRotation<ValueType>(generator));
+		to.push_back(randomRotation<ValueType>(generator));
+	}
+
+	for (ValueType &weight : weights)
+	{
+		weight = distribution(generator);
+	}
+
+	QuaternionSoA<ValueType, Layout> linear		= from.clone();
+	QuaternionSoA<ValueType, Layout> spherical	= from.clone();
+	QuaternionSoA<ValueType, Layout> fast		= from.clone();
+
+	nlerp(from.view(offset, count), to.view(offset, count), weights, linear.view(offset, count), 64u);
+	slerp(from.view(offset, count), to.view(offset, count), weights, spherical.view(offset, count), 64u);
+	fastSlerp(from.view(offset, count), to.view(offset, count), weights, fast.view(offset, count), 64u);
+
+	for (std::size_t index = 0u; index < size; ++index)
+	{
+		if ((index < offset) | (index >= (offset + count)))
+		{
+			assertEqual(Vector4<ValueType>(linear[index]), Vector4<ValueType>(from[index]));
+			continue;
+		}
+
+		const ValueType weight = weights[index - offset];
+
+		assertNear(linear[index], nlerp(from[index], to[index], weight), tolerance);
+		assertNear(spherical[index], slerp(from[index], to[index], weight), tolerance);
+		assertNear(fast[index], fastSlerp(from[index], to[index], weight), tolerance);
+		assertNear(fast[index], spherical[index], ValueType(1.0E-4));
+	}
+
+	// Blending in place over whole containers
+	std::vector<ValueType> halves(size, ValueType(0.5));
+
+	QuaternionSoA<ValueType, Layout> blended = from.clone();
+	slerp(blended, to, halves, blended);
+
+	for (std::size_t index = 0u; index < size; ++index)
+	{
+		assertNear(blended[index], slerp(from[index], to[index], ValueType(0.5)), tolerance);
+	}
+}
+
+int main(int, char **)
+{
+	testInterpolation<float>();
+	testInterpolation<double>();
+
+	testContainer<float, layout::SoA>();
+	testContainer<double, layout::AoSoA<4u>>();
+
+	testBlend<float, layout::SoA>();
+	testBlend<double, layout::SoA>();
+	testBlend<float, layout::AoSoA<8u>>();
+
+	{
+		// A thousand skeletons of 64 bones blended between two poses each
+		constexpr std::size_t count			= 64000u;
+		constexpr std::size_t iterations	= 100u;
+
+		std::mt19937							generator{14u};
+		std::uniform_real_distribution<float>	distribution{0.0f, 1.0f};
+
+		std::vector<Quaternion_f>	fromPoses;
+		std::vector<Quaternion_f>	toPoses;
+		std::vector<Quaternion_f>	blendedPoses(count);
+		std::vector<float>			weights(count);
+
+		for (std::size_t index = 0u; index < count; ++index)
+		{
+			fromPoses.push_back(randomRotation<float>(generator));
+			toPoses.push_back(randomRotation<float>(generator));
+			weights[index] = distribution(generator);
+		}
+
+		const QuaternionSoA_f from{std::span<const Quaternion_f>{fromPoses}};
+		const QuaternionSoA_f to{std::span<const Quaternion_f>{toPoses}};
+
+		QuaternionSoA_f blended(count);
+
+		std::chrono::duration<double> actualDuration;
+		benchmark(iterations, actualDuration, [&fromPoses, &toPoses, &blendedPoses, &weights]()
+		{
+			for (std::size_t index = 0u; index < count; ++index)
+			{
+				blendedPoses[index] = slerp(fromPoses[index], toPoses[index], weights[index]);
+			}
+		});
+
+		std::cout << count << " quaternions slerped one by one in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		benchmark(iterations, actualDuration, [&from, &to, &blended, &weights]()
+		{
+			slerp(from, to, weights, blended);
+		});
+
+		std::cout << count << " quaternions slerped in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		benchmark(iterations, actualDuration, [&from, &to, &blended, &weights]()
+		{
+			fastSlerp(from, to, weights, blended);
+		});
+
+		std::cout << count << " quaternions slerped by polynomial in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		benchmark(iterations, actualDuration, [&from, &to, &blended, &weights]()
+		{
+			nlerp(from, to, weights, blended);
+		});
+
+		std::cout << count << " quaternions nlerped in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <spatialindex.hpp>
+
+#include "test.hpp"
+
+using namespace nd::math;
+
+template <typename Layout>
+void testIndex()
+{
+	using Points	= VectorSoA<double, 3u, Layout>;
+	using Index		= SpatialIndex<double, 3u, Layout>;
+
+	// The index references its points, so temporaries are rejected
+	static_assert(std::is_constructible_v<Index, const Points &> & !std::is_constructible_v<Index, Points &&>);
+
+	constexpr std::size_t count = 5003u;
+
+	std::mt19937							generator{42u};
+	std::uniform_real_distribution<double>	distribution{-10.0, 10.0};
+
+	const auto random = [&generator, &distribution]()
+	{
+		return ColumnVector3_d{{distribution(generator), distribution(generator), distribution(generator)}};
+	};
+
+	Points points;
+
+	{
+		const Index index{points};
+
+		assertEqual(index.empty(), true);
+		assertEqual(index.nearest(ColumnVector3_d{traits::initialization::zero}), Index::none);
+		assertEqual(index.intersect(ColumnVector3_d{traits::initialization::zero}, ColumnVector3_d{{1.0, 0.0, 0.0}}, 1.0).index, Index::none);
+	}
+
+	for (std::size_t point = 0u; point < count; ++point)
+	{
+		points.push_back(random());
+	}
+
+	Index index{points};
+
+	const auto squareDistance = [&points](const std::size_t point, const ColumnVector3_d &query)
+	{
+		return (ColumnVector3_d(points[point]) - query).squareNorm();
+	};
+
+	const auto check = [&]()
+	{
+		assertEqual(index.bounds(), bounds(points));
+
+		for (std::size_t iteration = 0u; iteration < 100u; ++iteration)
+		{
+			const ColumnVector3_d query = random() * 1.2;
+
+			// Brute force reference, sorted by distance
+			std::vector<std::size_t> expected(count);
+
+			for (std::size_t point = 0u; point < count; ++point)
+			{
+				expected[point] = point;
+			}
+
+			std::sort(expected.begin(), expected.end(), [&squareDistance, &query](const std::size_t left, const std::size_t right)
+			{
+				return squareDistance(left, query) < squareDistance(right, query);
+			});
+
+			assertEqual(index.nearest(query), expected.front());
+
+			std::size_t	neighbours[8u];
+			double		squareDistances[8u];
+
+			assertEqual(index.nearest(query, neighbours, squareDistances), std::size_t{8u});
+			assertEqual(std::vector<std::size_t>(neighbours, neighbours + 8u), std::vector<std::size_t>(expected.begin(), expected.begin() + 8u));
+
+			const double radius = 2.5;
+
+			std::vector<std::size_t> within = index.within(query, radius);
+			std::vector<std::size_t> expectedWithin;
+
+			std::copy_if(expected.begin(), expected.end(), std::back_inserter(expectedWithin), [&](const std::size_t point)
+			{
+				return squareDistance(point, query) <= radius * radius;
+			});
+
+			std::sort(within.begin(), within.end());
+			std::sort(expectedWithin.begin(), expectedWithin.end());
+
+			assertEqual(within, expectedWithin);
+
+			// Rays hit the first point projecting onto them within the radius
+			const ColumnVector3_d	origin		= random() * 2.0;
+			const ColumnVector3_d	direction	= query - origin;
+			const double			hitRadius	= 0.3;
+
+			typename Index::Hit expectedHit;
+
+			for (std::size_t point = 0u; point < count; ++point)
+			{
+				const ColumnVector3_d	offset		= ColumnVector3_d(points[point]) - origin;
+				const double			distance	= (offset.transposed() * direction)[0u] / direction.squareNorm();
+
+				if ((distance >= 0.0) && (distance < expectedHit.distance) && ((offset - direction * distance).squareNorm() <= hitRadius * hitRadius))
+				{
+					expectedHit = typename Index::Hit{point, distance};
+				}
+			}
+
+			assertEqual(index.intersect(origin, direction, hitRadius).index, expectedHit.index);
+			assertEqual(index.intersect(origin, direction, hitRadius, 0.0).index, Index::none);
+		}
+	};
+
+	check();
+
+	// Refitting keeps the hierarchy valid for moved points
+	for (std::size_t point = 0u; point < count; ++point)
+	{
+		points[point] += ColumnVector3_d{{1.0, -2.0, 0.5}} + random() * 0.1;
+	}
+
+	index.refit();
+	check();
+
+	// Batched queries match single ones
+	Points queries;
+
+	for (std::size_t query = 0u; query < 1000u; ++query)
+	{
+		queries.push_back(random());
+	}
+
+	std::vector<std::size_t> result(queries.size());
+	index.nearest(queries, result, 64u);
+
+	for (std::size_t query = 0u; query < queries.size(); ++query)
+	{
+		assertEqual(result[query], index.nearest(ColumnVector3_d(queries[query])));
+	}
+
+	// Fewer points than neighbours requested
+	points.resize(3u);
+	index.build();
+
+	std::size_t	neighbours[8u];
+	double		squareDistances[8u];
+
+	assertEqual(index.nearest(ColumnVector3_d{traits::initialization::zero}, neighbours, squareDistances), std::size_t{3u});
+	assertEqual(squareDistances[0u] <= squareDistances[1u], true);
+	assertEqual(squareDistances[1u] <= squareDistances[2u], true);
+}
+
+int main(int, char **)
+{
+	testIndex<layout::SoA>();
+	testIndex<layout::AoSoA<4u>>();
+
+	{
+		constexpr std::size_t count			= 1000000u;
+		constexpr std::size_t queryCount	= 100000u;
+		constexpr std::size_t iterations	= 3u;
+
+		std::mt19937							generator{7u};
+		std::uniform_real_distribution<float>	distribution{0.0f, 100.0f};
+
+		VectorSoA3_f points;
+		VectorSoA3_f queries;
+
+		for (std::size_t point = 0u; point < count; ++point)
+		{
+			points.emplace_back(distribution(generator), distribution(generator), distribution(generator));
+		}
+
+		for (std::size_t query = 0u; query < queryCount; ++query)
+		{
+			queries.emplace_back(distribution(generator), distribution(generator), distribution(generator));
+		}
+
+		SpatialIndex<float, 3u> index{points};
+
+		std::chrono::duration<double> actualDuration;
+		benchmark(iterations, actualDuration, [&index]()
+		{
+			index.build();
+		});
+
+		std::cout << count << " points indexed in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		benchmark(iterations, actualDuration, [&index]()
+		{
+			index.refit();
+		});
+
+		std::cout << count << " points refitted in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		std::vector<std::size_t> result(queryCount);
+
+		benchmark(iterations, actualDuration, [&index, &queries, &result]()
+		{
+			index.nearest(queries, result);
+		});
+
+		std::cout << queryCount << " nearest neighbours among " << count << " points found in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		// Brute force for a ten thousandth of the queries
+		benchmark(1u, actualDuration, [&points, &queries, &result]()
+		{
+			for (std::size_t query = 0u; query < queryCount / 10000u; ++query)
+			{
+				const ColumnVector3_f	position	= queries[query];
+				float					best		= std::numeric_limits<float>::infinity();
+
+				for (std::size_t point = 0u; point < count; ++point)
+				{
+					const float distance = (ColumnVector3_f(points[point]) - position).squareNorm();
+
+					if (distance < best)
+					{
+						best			= distance;
+						result[query]	= point;
+					}
+				}
+			}
+		});
+
+		std::cout << queryCount / 10000u << " nearest neighbours among " << count << " points found by brute force in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() << " us\n";
+	}
+
+	return EXIT_SUCCESS;
+}
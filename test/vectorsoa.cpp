@@ -0,0 +1,705 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <vectorsoa.hpp>
+
+#include "numeric.hpp"
+#include "test.hpp"
+
+using namespace nd::math;
+
+template <typename Layout>
+void testBatch()
+{
+	// Sizes that are not a multiple of any register width exercise the scalar tails
+	constexpr std::size_t count = 1003u;
+
+	VectorSoA<double, 3u, Layout> left;
+	VectorSoA<double, 3u, Layout> right;
+
+	for (std::size_t index = 0u; index < count; ++index)
+	{
+		left.emplace_back(double(index % 7u) - 3.0, double(index % 5u), 1.0);
+		right.emplace_back(2.0, double(index % 3u) - 1.0, double(index % 11u));
+	}
+
+	std::vector<double> dots(count);
+	std::vector<double> norms(count);
+
+	dot(left, right, std::span<double>{dots});
+	norm(left, std::span<double>{norms});
+
+	VectorSoA<double, 3u, Layout> crosses{count};
+	cross(left, right, crosses);
+
+	for (std::size_t index = 0u; index < count; ++index)
+	{
+		const ColumnVector3_d l = left[index];
+		const ColumnVector3_d r = right[index];
+
+		assertEqual(dots[index], l[0u] * r[0u] + l[1u] * r[1u] + l[2u] * r[2u]);
+		assertEqual(norms[index], l.norm());
+		assertEqual(ColumnVector3_d(crosses[index]), l.cross(r));
+	}
+
+	// In place, aliasing the left operand
+	VectorSoA<double, 3u, Layout> aliased = left.clone();
+	cross(aliased, right, aliased);
+	assertEqual(ColumnVector3_d(aliased[1001u]), ColumnVector3_d(crosses[1001u]));
+
+	axpy(2.0, left, right);
+	assertEqual(ColumnVector3_d(right[1002u]), ColumnVector3_d{{-2.0, 3.0, 3.0}});
+
+	scale(right, 0.5);
+	assertEqual(ColumnVector3_d(right[1002u]), ColumnVector3_d{{-1.0, 1.5, 1.5}});
+
+	normalize(left);
+
+	for (std::size_t index = 0u; index < count; ++index)
+	{
+		assertNear(ColumnVector3_d(left[index]).norm(), 1.0, 1.0E-12);
+	}
+}
+
+template <typename ValueType, std::size_t Order, typename Layout>
+void testConversion()
+{
+	constexpr std::size_t count = 1001u;
+
+	std::vector<Vector<ValueType, Order>>		rows(count);
+	std::vector<ColumnVector<ValueType, Order>>	columns(count);
+
+	for (std::size_t index = 0u; index < count; ++index)
+	{
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			rows[index][order] = ValueType(index * Order + order);
+		}
+	}
+
+	VectorSoA<ValueType, Order, Layout> vectors{rows};
+
+	assertEqual(vectors.size(), count);
+
+	for (std::size_t index = 0u; index < count; ++index)
+	{
+		for (std::size_t order = 0u; order < Order; ++order)
+		{
+			assertEqual(*vectors.data(order, index), ValueType(index * Order + order));
+		}
+	}
+
+	vectors.copyTo(columns);
+
+	for (std::size_t index = 0u; index < count; ++index)
+	{
+		assertEqual(columns[index], rows[index].transposed());
+	}
+
+	// Assigning replaces the previous vectors
+	vectors.assign(std::span{columns.data(), 17u});
+
+	assertEqual(vectors.size(), std::size_t{17u});
+	assertEqual(ColumnVector<ValueType, Order>(vectors[16u]), columns[16u]);
+}
+
+template <typename Layout>
+void testTransform()
+{
+	constexpr std::size_t count = 515u;
+
+	// Small integers keep every product exact, so batch and generic products must match bit for bit
+	const Matrix4x4_d affine = {{
+		2.0, 0.0, 1.0,  3.0,
+		0.0, 1.0, 0.0, -2.0,
+		1.0, 0.0, 3.0,  5.0,
+		0.0, 0.0, 0.0,  1.0
+	}};
+
+	const Matrix4x4_d projective = {{
+		2.0, 0.0, 0.0, 0.0,
+		0.0, 4.0, 0.0, 0.0,
+		0.0, 0.0, 1.0, 1.0,
+		0.0, 0.0, 1.0, 0.0
+	}};
+
+	VectorSoA<double, 3u, Layout> points;
+
+	for (std::size_t index = 0u; index < count; ++index)
+	{
+		points.emplace_back(double(index % 13u) - 6.0, double(index % 7u), double(index % 4u) + 1.0);
+	}
+
+	VectorSoA<double, 3u, Layout> transformed{count};
+	VectorSoA<double, 3u, Layout> directions{count};
+	VectorSoA<double, 3u, Layout> projected{count};
+
+	transformPoints(affine, points, transformed);
+	transformDirections(affine, points, directions);
+	projectPoints(projective, points, projected);
+
+	for (std::size_t index = 0u; index < count; ++index)
+	{
+		const ColumnVector3_d	point		= points[index];
+		const ColumnVector4_d	homogeneous	= {{point[0u], point[1u], point[2u], 1.0}};
+		const ColumnVector4_d	direction	= {{point[0u], point[1u], point[2u], 0.0}};
+		const ColumnVector4_d	point4		= affine * homogeneous;
+		const ColumnVector4_d	direction4	= affine * direction;
+		const ColumnVector4_d	clip		= projective * homogeneous;
+
+		assertEqual(ColumnVector3_d(transformed[index]), ColumnVector3_d{{point4[0u], point4[1u], point4[2u]}});
+		assertEqual(ColumnVector3_d(directions[index]), ColumnVector3_d{{direction4[0u], direction4[1u], direction4[2u]}});
+		assertEqual(ColumnVector3_d(projected[index]), ColumnVector3_d{{clip[0u] / clip[3u], clip[1u] / clip[3u], clip[2u] / clip[3u]}});
+	}
+
+	transformPoints(affine, points);
+	assertEqual(ColumnVector3_d(points[514u]), ColumnVector3_d(transformed[514u]));
+}
+
+template <typename Layout>
+void testParallel()
+{
+	constexpr std::size_t count = 10007u;
+
+	const Matrix4x4_d matrix = {{
+		0.0, -1.0, 0.0,  1.0,
+		1.0,  0.0, 0.0,  2.0,
+		0.0,  0.0, 2.0, -1.0,
+		0.0,  0.0, 0.0,  1.0
+	}};
+
+	VectorSoA<double, 3u, Layout> vectors;
+
+	for (std::size_t index = 0u; index < count; ++index)
+	{
+		vectors.emplace_back(double(index % 13u) + 1.0, double(index % 7u), double(index % 4u));
+	}
+
+	// Views of a range behave like the container itself
+	const auto view = vectors.view(100u, 20u);
+
+	assertEqual(view.size(), std::size_t{20u});
+	assertEqual(ColumnVector3_d(view[5u]), ColumnVector3_d(vectors[105u]));
+	assertEqual(ColumnVector3_d(*view.subview(4u, 2u).begin()), ColumnVector3_d(vectors[104u]));
+	assertEqual(view.end() - view.begin(), std::ptrdiff_t{20});
+
+	// Views may start anywhere within a block of the interleaved layouts
+	VectorSoA<double, 3u, Layout> shifted = vectors.clone();
+
+	scale(shifted.view(3u, 50u), 2.0);
+	axpy(1.0, vectors.view(1u, 60u), shifted.view(2u, 60u));
+
+	for (std::size_t index = 0u; index < 64u; ++index)
+	{
+		const bool				scaled		= (index >= 3u) & (index < 53u);
+		const bool				added		= (index >= 2u) & (index < 62u);
+		const ColumnVector3_d	expected	= ColumnVector3_d(vectors[index]) * (scaled ? 2.0 : 1.0)
+											  + (added ? ColumnVector3_d(vectors[index - 1u]) : ColumnVector3_d{traits::initialization::zero});
+
+		assertEqual(ColumnVector3_d(shifted[index]), expected);
+	}
+
+	// Small grains split the vectors into many chunks, whose results have to match the sequential kernels exactly
+	VectorSoA<double, 3u, Layout> expected = vectors.clone();
+	VectorSoA<double, 3u, Layout> transformed{count};
+
+	normalize(expected);
+	parallelForEach(vectors, [](const typename VectorSoA<double, 3u, Layout>::View chunk)
+	{
+		normalize(chunk);
+	}, 100u);
+
+	for (std::size_t index = 0u; index < count; ++index)
+	{
+		assertEqual(ColumnVector3_d(vectors[index]), ColumnVector3_d(expected[index]));
+	}
+
+	transformPoints(matrix, expected);
+	parallelTransform(vectors, transformed, [&matrix](const auto input, const auto output)
+	{
+		transformPoints(matrix, input, output);
+	}, 1000u);
+
+	for (std::size_t index = 0u; index < count; ++index)
+	{
+		assertEqual(ColumnVector3_d(transformed[index]), ColumnVector3_d(expected[index]));
+	}
+
+	// Chunks are reduced in order, so integral sums are exact and every chunk is visited once
+	const std::size_t chunks = parallelReduce(vectors, std::size_t{0u}, [](const auto)
+	{
+		return std::size_t{1u};
+	}, std::plus<>{}, 1000u);
+
+	const std::size_t sum = parallelReduce(transformed, std::size_t{0u}, [](const auto chunk)
+	{
+		return chunk.size();
+	}, std::plus<>{}, 1000u);
+
+	assertEqual(chunks, (count + 999u) / 1000u);
+	assertEqual(sum, count);
+}
+
+template <typename Layout>
+void testStatistics()
+{
+	constexpr std::size_t count = 1037u;
+
+	VectorSoA<double, 3u, Layout> vectors;
+	BoundingBox3_d expected = BoundingBox3_d::empty();
+	ColumnVector3_d sum{traits::initialization::zero};
+
+	assertEqual(statistics(vectors).bounds.isEmpty(), true);
+
+	for (std::size_t index = 0u; index < count; ++index)
+	{
+		const ColumnVector3_d vector = {{double((index * 37u) % 101u) - 50.0, double((index * 11u) % 29u), -double(index % 17u)}};
+
+		vectors.push_back(vector);
+		expected.merge(vector);
+		sum += vector;
+	}
+
+	// Integral values keep the sums exact regardless of the order of the additions
+	const VectorStatistics<double, 3u> result = statistics(vectors);
+
+	assertEqual(result.bounds, expected);
+	assertEqual(result.sum, sum);
+	assertEqual(result.count, count);
+	assertEqual(centroid(vectors), ColumnVector3_d(sum / double(count)));
+	assertEqual(bounds(vectors).contains(ColumnVector3_d(vectors[500u])), true);
+
+	const VectorStatistics<double, 3u> parallel = parallelStatistics(vectors, 64u);
+
+	assertEqual(parallel.bounds, expected);
+	assertEqual(parallel.sum, sum);
+	assertEqual(parallel.count, count);
+
+	// Bounds of a range starting within a block
+	BoundingBox3_d range = BoundingBox3_d::empty();
+
+	for (std::size_t index = 5u; index < 105u; ++index)
+	{
+		range.merge(ColumnVector3_d(vectors[index]));
+	}
+
+	assertEqual(bounds(vectors.view(5u, 100u)), range);
+}
+
+int main(int, char **)
+{
+	{
+		VectorSoA3_f vectors;
+
+		assertEqual(vectors.empty(), true);
+
+		for (std::size_t index = 0u; index < 1000u; ++index)
+		{
+			if ((index % 2u) == 0u)
+			{
+				vectors.push_back(ColumnVector3_f{{float(index), -float(index), 1.0f}});
+			}
+			else
+			{
+				vectors.emplace_back(float(index), -float(index), 1.0f);
+			}
+		}
+
+		assertEqual(vectors.size(), std::size_t{1000u});
+		assertEqual(ColumnVector3_f(vectors[777u]), ColumnVector3_f{{777.0f, -777.0f, 1.0f}});
+
+		// Components are contiguous, cache line aligned and share one allocation
+		for (std::size_t order = 0u; order < 3u; ++order)
+		{
+			assertEqual(reinterpret_cast<std::uintptr_t>(vectors.data(order)) % simd::cacheLineSize, std::uintptr_t{0u});
+			assertEqual(vectors.component(order).size(), std::size_t{1000u});
+		}
+
+		assertEqual(vectors.data(1u) - vectors.data(0u), std::ptrdiff_t(vectors.capacity()));
+
+		for (float &y : vectors.component(1u))
+		{
+			y = -y;
+		}
+
+		assertEqual(ColumnVector3_f(vectors[999u]), ColumnVector3_f{{999.0f, 999.0f, 1.0f}});
+
+		vectors.resize(1200u);
+
+		assertEqual(ColumnVector3_f(vectors[1100u]), ColumnVector3_f{traits::initialization::zero});
+		assertEqual(ColumnVector3_f(vectors[500u]), ColumnVector3_f{{500.0f, 500.0f, 1.0f}});
+
+		const VectorSoA3_f copy = vectors.clone();
+		VectorSoA3_f moved = std::move(vectors);
+
+		assertEqual(vectors.size(), std::size_t{0u});
+		assertEqual(moved.size(), copy.size());
+		assertEqual(ColumnVector3_f(moved[123u]), ColumnVector3_f(copy[123u]));
+
+		moved.pop_back();
+		moved.clear();
+
+		assertEqual(moved.empty(), true);
+		assertEqual(moved.capacity() >= std::size_t{1200u}, true);
+	}
+
+	{
+		VectorSoA3_f vectors{100u};
+
+		// References write through to the component arrays
+		vectors[10u] = ColumnVector3_f{{1.0f, 2.0f, 3.0f}};
+		vectors[11u][2u] = 4.0f;
+		vectors[12u] = vectors[10u];
+		vectors[12u] += ColumnVector3_f{{1.0f, 1.0f, 1.0f}};
+		vectors[12u] *= 2.0f;
+
+		assertEqual(vectors.component(0u)[10u], 1.0f);
+		assertEqual(vectors.component(2u)[11u], 4.0f);
+		assertEqual(ColumnVector3_f(vectors[12u]), ColumnVector3_f{{4.0f, 6.0f, 8.0f}});
+
+		swap(vectors[10u], vectors[12u]);
+
+		assertEqual(ColumnVector3_f(vectors[10u]), ColumnVector3_f{{4.0f, 6.0f, 8.0f}});
+
+		std::for_each(vectors.begin(), vectors.end(), [index = 0.0f](const VectorSoA3_f::reference vector) mutable
+		{
+			vector = ColumnVector3_f{{index, 2.0f * index, 1.0f}};
+			index += 1.0f;
+		});
+
+		VectorSoA3_f result{vectors.size()};
+
+		std::transform(vectors.cbegin(), vectors.cend(), result.begin(), [](const ColumnVector3_f &vector)
+		{
+			return vector * 2.0f;
+		});
+
+		assertEqual(result.end() - result.begin(), std::ptrdiff_t{100});
+		assertEqual(ColumnVector3_f(result[42u]), ColumnVector3_f{{84.0f, 168.0f, 2.0f}});
+
+		std::reverse(result.begin(), result.end());
+
+		assertEqual(ColumnVector3_f(result[57u]), ColumnVector3_f{{84.0f, 168.0f, 2.0f}});
+		assertEqual(ColumnVector3_f(*(result.cbegin() + 99)), ColumnVector3_f{{0.0f, 0.0f, 2.0f}});
+
+		const auto found = std::find_if(result.cbegin(), result.cend(), [](const ColumnVector3_f &vector)
+		{
+			return vector[0u] < 100.0f;
+		});
+
+		assertEqual(found - result.cbegin(), std::ptrdiff_t{50});
+	}
+
+	testBatch<layout::SoA>();
+	testBatch<layout::AoSoA<4u>>();
+	testBatch<layout::AoSoA<8u>>();
+
+	testConversion<float, 2u, layout::SoA>();
+	testConversion<float, 3u, layout::SoA>();
+	testConversion<float, 4u, layout::SoA>();
+	testConversion<double, 2u, layout::SoA>();
+	testConversion<double, 3u, layout::SoA>();
+	testConversion<double, 4u, layout::SoA>();
+	testConversion<float, 3u, layout::AoSoA<8u>>();
+	testConversion<double, 4u, layout::AoSoA<4u>>();
+	testConversion<std::int32_t, 3u, layout::SoA>();
+
+	testTransform<layout::SoA>();
+	testTransform<layout::AoSoA<4u>>();
+
+	testParallel<layout::SoA>();
+	testParallel<layout::AoSoA<4u>>();
+
+	testStatistics<layout::SoA>();
+	testStatistics<layout::AoSoA<4u>>();
+	testStatistics<layout::AoSoA<8u>>();
+
+	{
+		BoundingBox2_f box = BoundingBox2_f::empty();
+
+		assertEqual(box.isEmpty(), true);
+
+		box.merge(ColumnVector2_f{{1.0f, -2.0f}}).merge(ColumnVector2_f{{3.0f, 4.0f}});
+
+		assertEqual(box.isEmpty(), false);
+		assertEqual(box.center(), ColumnVector2_f{{2.0f, 1.0f}});
+		assertEqual(box.extent(), ColumnVector2_f{{2.0f, 6.0f}});
+		assertEqual(box.contains(ColumnVector2_f{{3.0f, 0.0f}}), true);
+		assertEqual(box.contains(ColumnVector2_f{{3.5f, 0.0f}}), false);
+
+		// NaN components do not enter the bounds
+		VectorSoA2_f vectors;
+		vectors.emplace_back(1.0f, 2.0f);
+		vectors.emplace_back(std::nanf(""), -1.0f);
+
+		assertEqual(bounds(vectors), BoundingBox2_f{{{1.0f, -1.0f}}, {{1.0f, 2.0f}}});
+	}
+
+	{
+		constexpr std::size_t	count		= 10000000u;
+		constexpr std::size_t	iterations	= 5u;
+
+		const Matrix4x4_f matrix = {{
+			0.0f, -1.0f, 0.0f,  1.0f,
+			1.0f,  0.0f, 0.0f,  2.0f,
+			0.0f,  0.0f, 2.0f, -1.0f,
+			0.0f,  0.0f, 0.0f,  1.0f
+		}};
+
+		VectorSoA3_f points{count};
+
+		std::chrono::duration<double> actualDuration;
+		benchmark(iterations, actualDuration, [&matrix, &points]()
+		{
+			for (VectorSoA3_f::reference point : points)
+			{
+				const ColumnVector4_f homogeneous = {{point[0u], point[1u], point[2u], 1.0f}};
+				const ColumnVector4_f transformed = matrix * homogeneous;
+
+				point = ColumnVector3_f{{transformed[0u], transformed[1u], transformed[2u]}};
+			}
+		});
+
+		std::cout << count << " points transformed one by one in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		benchmark(iterations, actualDuration, [&matrix, &points]()
+		{
+			transformPoints(matrix, points);
+		});
+
+		std::cout << count << " points transformed in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+	}
+
+	{
+		// Blocked layouts keep values across reallocations and through iterators
+		VectorAoSoA3_f vectors;
+
+		for (std::size_t index = 0u; index < 100u; ++index)
+		{
+			vectors.emplace_back(float(index), 2.0f * float(index), -1.0f);
+		}
+
+		assertEqual(vectors.capacity() % std::size_t{16u}, std::size_t{0u});
+		assertEqual(ColumnVector3_f(vectors[77u]), ColumnVector3_f{{77.0f, 154.0f, -1.0f}});
+
+		// All components of a vector lie within one block
+		assertEqual(vectors.data(2u, 77u) - vectors.data(0u, 77u), std::ptrdiff_t{32});
+
+		vectors[77u][1u] = 0.0f;
+		std::reverse(vectors.begin(), vectors.end());
+
+		assertEqual(ColumnVector3_f(vectors[22u]), ColumnVector3_f{{77.0f, 0.0f, -1.0f}});
+		assertEqual(ColumnVector3_f(*(vectors.cend() - 1)), ColumnVector3_f{{0.0f, 0.0f, -1.0f}});
+
+		const VectorAoSoA3_f copy = vectors.clone();
+		vectors.resize(1000u);
+
+		assertEqual(ColumnVector3_f(vectors[999u]), ColumnVector3_f{traits::initialization::zero});
+		assertEqual(ColumnVector3_f(vectors[50u]), ColumnVector3_f(copy[50u]));
+	}
+
+	{
+		// Random access gathers of whole vectors, which touch Order distant cache lines with SoA and a single block with AoSoA
+		constexpr std::size_t	count		= 4000000u;
+		constexpr std::size_t	iterations	= 5u;
+
+		VectorSoA3_f	vectors{count};
+		VectorAoSoA3_f	blocked{count};
+
+		std::vector<std::uint32_t> indices(count);
+
+		for (std::size_t index = 0u; index < count; ++index)
+		{
+			indices[index] = std::uint32_t((index * 2654435761u) % count);
+		}
+
+		float sum = 0.0f;
+
+		std::chrono::duration<double> actualDuration;
+		benchmark(iterations, actualDuration, [&vectors, &indices, &sum]()
+		{
+			for (const std::uint32_t index : indices)
+			{
+				sum += ColumnVector3_f(vectors[index]).squareNorm();
+			}
+		});
+
+		std::cout << count << " random gathers from SoA in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		benchmark(iterations, actualDuration, [&blocked, &indices, &sum]()
+		{
+			for (const std::uint32_t index : indices)
+			{
+				sum += ColumnVector3_f(blocked[index]).squareNorm();
+			}
+		});
+
+		std::cout << count << " random gathers from AoSoA in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		assertEqual(sum, 0.0f);
+	}
+
+	{
+		constexpr std::size_t	count		= 10000000u;
+		constexpr std::size_t	iterations	= 5u;
+		VectorSoA3_f			vectors{count};
+		std::vector<Vector3_f>	array(count, Vector3_f{{1.0f, 2.0f, 3.0f}});
+
+		std::fill(vectors.component(0u).begin(), vectors.component(0u).end(), 1.0f);
+		std::fill(vectors.component(1u).begin(), vectors.component(1u).end(), 2.0f);
+		std::fill(vectors.component(2u).begin(), vectors.component(2u).end(), 3.0f);
+
+		std::chrono::duration<double> actualDuration;
+		benchmark(iterations, actualDuration, [&array]()
+		{
+			for (Vector3_f &vector : array)
+			{
+				vector.normalize();
+			}
+		});
+
+		std::cout << count << " array of structures normalizations in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		benchmark(iterations, actualDuration, [&vectors]()
+		{
+			normalize(vectors);
+		});
+
+		std::cout << count << " batch normalizations in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		benchmark(iterations, actualDuration, [&vectors]()
+		{
+			parallelForEach(vectors, [](const VectorSoA3_f::View chunk)
+			{
+				normalize(chunk);
+			});
+		});
+
+		std::cout << count << " parallel batch normalizations on " << ThreadPool::instance().concurrency() << " threads in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+	}
+
+	{
+		constexpr std::size_t	count		= 10000000u;
+		constexpr std::size_t	iterations	= 5u;
+		VectorSoA3_f			points;
+
+		points.assign(std::vector<ColumnVector3_f>(count, ColumnVector3_f{{1.0f, -2.0f, 3.0f}}));
+		points[count / 2u] = ColumnVector3_f{{5.0f, 5.0f, 5.0f}};
+
+		BoundingBox3_f box;
+
+		std::chrono::duration<double> actualDuration;
+		benchmark(iterations, actualDuration, [&points, &box]()
+		{
+			box = BoundingBox3_f::empty();
+
+			for (std::size_t index = 0u; index < points.size(); ++index)
+			{
+				box.merge(ColumnVector3_f(points[index]));
+			}
+		});
+
+		assertEqual(box.maximum, ColumnVector3_f{{5.0f, 5.0f, 5.0f}});
+
+		std::cout << count << " points bounded one by one in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		benchmark(iterations, actualDuration, [&points, &box]()
+		{
+			box = statistics(points).bounds;
+		});
+
+		assertEqual(box.maximum, ColumnVector3_f{{5.0f, 5.0f, 5.0f}});
+
+		std::cout << count << " points bounded by a single pass batch reduction in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		benchmark(iterations, actualDuration, [&points, &box]()
+		{
+			box = parallelStatistics(points).bounds;
+		});
+
+		assertEqual(box.maximum, ColumnVector3_f{{5.0f, 5.0f, 5.0f}});
+
+		std::cout << count << " points bounded by a parallel batch reduction in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+	}
+
+	{
+		constexpr std::size_t	count		= 1000000u;
+		constexpr std::size_t	iterations	= 10u;
+
+		const std::vector<Vector3_f>	source(count, Vector3_f{{1.0f, 2.0f, 3.0f}});
+		std::vector<Vector3_f>			destination(count);
+		VectorSoA3_f					vectors;
+
+		std::chrono::duration<double> actualDuration;
+		benchmark(iterations, actualDuration, [&source, &vectors]()
+		{
+			vectors.clear();
+
+			for (const Vector3_f &vector : source)
+			{
+				vectors.push_back(vector.transposed());
+			}
+		});
+
+		std::cout << count << " vectors pushed back in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		benchmark(iterations, actualDuration, [&source, &vectors]()
+		{
+			vectors.assign(source);
+		});
+
+		std::cout << count << " vectors assigned in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		benchmark(iterations, actualDuration, [&destination, &vectors]()
+		{
+			vectors.copyTo(destination);
+		});
+
+		std::cout << count << " vectors copied to an array of structures in "
+				  << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations) << " us\n";
+
+		assertEqual(destination, source);
+	}
+
+	{
+		constexpr std::size_t	count		= 1000000u;
+		constexpr std::size_t	iterations	= 10u;
+		VectorSoA3_f			vectors;
+
+		std::chrono::duration<double> actualDuration;
+		benchmark(iterations, actualDuration, [&vectors]()
+		{
+			vectors.clear();
+
+			for (std::size_t index = 0u; index < count; ++index)
+			{
+				vectors.emplace_back(float(index), 0.0f, 1.0f);
+			}
+		});
+
+		std::cout << iterations * count << " appended in " << std::chrono::duration_cast<std::chrono::microseconds>(actualDuration).count() / double(iterations)
+				  << " us per million\n";
+	}
+
+	return EXIT_SUCCESS;
+}